@@ -35,6 +35,8 @@
 extern "C" {
 #endif
 
+struct QueueStats_t;
+
 void init(void);
 
 void disablePeripheralsClocks(void);
@@ -109,6 +111,11 @@ uint8_t digitalRead(uint8_t pin);
     void Serial_writeBuff(const void *buff, uint16_t length);
     int Serial_print(const char *format, ...);
     int16_t Serial_read(void);
+    uint16_t Serial_readBuff(void *buff, uint16_t length);
+#if (QUEUE_STATS_ENABLE != 0)
+    void Serial_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx);
+    void Serial_resetStats(void);
+#endif
 #endif /* SERIAL_ENABLE */
 
 #if (defined(SERIAL1_ENABLE) && SERIAL1_ENABLE != 0)
@@ -121,6 +128,11 @@ uint8_t digitalRead(uint8_t pin);
     void Serial1_writeBuff(const void *buff, uint16_t length);
     int Serial1_print(const void *format, ...);
     int16_t Serial1_read(void);
+    uint16_t Serial1_readBuff(void *buff, uint16_t length);
+#if (QUEUE_STATS_ENABLE != 0)
+    void Serial1_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx);
+    void Serial1_resetStats(void);
+#endif
 #endif /* SERIAL1_ENABLE */
 
 #if (defined(SERIAL2_ENABLE) && SERIAL2_ENABLE != 0)
@@ -133,6 +145,11 @@ uint8_t digitalRead(uint8_t pin);
     void Serial2_writeBuff(const void *buff, uint16_t length);
     int Serial2_print(const void *format, ...);
     int16_t Serial2_read(void);
+    uint16_t Serial2_readBuff(void *buff, uint16_t length);
+#if (QUEUE_STATS_ENABLE != 0)
+    void Serial2_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx);
+    void Serial2_resetStats(void);
+#endif
 #endif /* SERIA2L_ENABLE */
 
 #if (defined(SERIAL3_ENABLE) && SERIAL3_ENABLE != 0)
@@ -145,6 +162,11 @@ uint8_t digitalRead(uint8_t pin);
     void Serial3_writeBuff(const void *buff, uint16_t length);
     int Serial3_print(const void *format, ...);
     int16_t Serial3_read(void);
+    uint16_t Serial3_readBuff(void *buff, uint16_t length);
+#if (QUEUE_STATS_ENABLE != 0)
+    void Serial3_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx);
+    void Serial3_resetStats(void);
+#endif
 #endif /* SERIAL3_ENABLE */
 
 #if (defined(I2C_ENABLE) && I2C_ENABLE != 0)
@@ -0,0 +1,164 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_SERIAL_H__
+#define __ARDUINUTIL_SERIAL_H__
+
+#include "Config.h"
+
+/* Queues used by the Serial drivers for the receive and transmit buffers.
+ SERIAL_QUEUE_DECLARE(name, length) declares struct name_t, a queue of length
+ bytes, and the functions name_init(), name_used(), name_empty(), name_write(),
+ name_read(), name_write_n(), name_read_n(), name_reserve() and
+ name_commit() (and name_getstats() and name_resetstats() with
+ QUEUE_STATS_ENABLE).
+
+ Each buffer has a single producer and a single consumer (the main loop and the
+ USART interrupt), therefore:
+ - SERIAL_QUEUE_TYPED selects the typed queue of Data/typedqueue.h (the buffer
+ sizes must be powers of two);
+ - SERIAL_QUEUE_SPSC selects SpscQueue_t;
+ - otherwise Queue_t is used. */
+#if (SERIAL_QUEUE_TYPED != 0)
+
+#include "Data/typedqueue.h"
+
+#define SERIAL_QUEUE_DECLARE(name, length) QUEUE_DECLARE(name, uint8_t, length)
+
+#else
+
+#if (SERIAL_QUEUE_SPSC != 0)
+
+#include "Data/spscqueue.h"
+
+#define SerialQueue_t       SpscQueue_t
+#define SerialQueue_init    SpscQueue_init
+#define SerialQueue_used    SpscQueue_used
+#define SerialQueue_empty   SpscQueue_empty
+#define SerialQueue_write   SpscQueue_write
+#define SerialQueue_read    SpscQueue_read
+#define SerialQueue_write_n SpscQueue_write_n
+#define SerialQueue_read_n  SpscQueue_read_n
+#define SerialQueue_reserve SpscQueue_reserve
+#define SerialQueue_commit  SpscQueue_commit
+#define SerialQueue_getstats   SpscQueue_getstats
+#define SerialQueue_resetstats SpscQueue_resetstats
+
+#else
+
+#include "Data/queue.h"
+
+#define SerialQueue_t       Queue_t
+#define SerialQueue_init    Queue_init
+#define SerialQueue_used    Queue_used
+#define SerialQueue_empty   Queue_empty
+#define SerialQueue_write   Queue_write
+#define SerialQueue_read    Queue_read
+#define SerialQueue_write_n Queue_write_n
+#define SerialQueue_read_n  Queue_read_n
+#define SerialQueue_reserve Queue_reserve
+#define SerialQueue_commit  Queue_commit
+#define SerialQueue_getstats   Queue_getstats
+#define SerialQueue_resetstats Queue_resetstats
+
+#endif /* SERIAL_QUEUE_SPSC */
+
+#if (QUEUE_STATS_ENABLE != 0)
+
+#define SERIAL_QUEUE_STATS_FUNCTIONS(name)                                     \
+static __inline void name##_getstats(const struct name##_t *o,                 \
+        struct QueueStats_t *stats)                                            \
+{                                                                              \
+    SerialQueue_getstats(&o->Queue, stats);                                    \
+}                                                                              \
+                                                                               \
+static __inline void name##_resetstats(struct name##_t *o)                     \
+{                                                                              \
+    SerialQueue_resetstats(&o->Queue);                                         \
+}
+
+#else
+
+#define SERIAL_QUEUE_STATS_FUNCTIONS(name)
+
+#endif /* QUEUE_STATS_ENABLE */
+
+#define SERIAL_QUEUE_DECLARE(name, length)                                     \
+                                                                               \
+struct name##_t {                                                              \
+    struct SerialQueue_t Queue;                                                \
+    uint8_t Buff[length];                                                      \
+};                                                                             \
+                                                                               \
+static __inline void name##_init(struct name##_t *o)                           \
+{                                                                              \
+    SerialQueue_init(&o->Queue, o->Buff, (length), 1U);                        \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_used(const struct name##_t *o)                   \
+{                                                                              \
+    return SerialQueue_used(&o->Queue);                                        \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_empty(const struct name##_t *o)                 \
+{                                                                              \
+    return SerialQueue_empty(&o->Queue);                                       \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_write(struct name##_t *o, const uint8_t *val)   \
+{                                                                              \
+    return SerialQueue_write(&o->Queue, val);                                  \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_read(struct name##_t *o, uint8_t *val)          \
+{                                                                              \
+    return SerialQueue_read(&o->Queue, val);                                   \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_write_n(struct name##_t *o,                      \
+        const uint8_t *buff, Size_t num)                                       \
+{                                                                              \
+    return SerialQueue_write_n(&o->Queue, buff, num);                          \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_read_n(struct name##_t *o,                       \
+        uint8_t *buff, Size_t num)                                             \
+{                                                                              \
+    return SerialQueue_read_n(&o->Queue, buff, num);                           \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_reserve(struct name##_t *o, Size_t num,         \
+        uint8_t **ptr, Size_t *contig)                                         \
+{                                                                              \
+    return SerialQueue_reserve(&o->Queue, num, ptr, contig);                   \
+}                                                                              \
+                                                                               \
+static __inline void name##_commit(struct name##_t *o, Size_t num)             \
+{                                                                              \
+    SerialQueue_commit(&o->Queue, num);                                        \
+}                                                                              \
+                                                                               \
+SERIAL_QUEUE_STATS_FUNCTIONS(name)
+
+#endif /* SERIAL_QUEUE_TYPED */
+
+#endif /* __ARDUINUTIL_SERIAL_H__ */
@@ -0,0 +1,205 @@
+/*
+ Arduinutil BcastRing - Broadcast ring buffer implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Data/bcastring.h"
+#include <string.h>
+
+#if (BCASTRING_ENABLE != 0)
+
+/* Slot of the item dist items before the next one to be written, which goes to
+ wpos. The slot is found from WritePos and not from the item sequence, since
+ Seq % Length jumps when the uint32_t sequence wraps if Length is not a power
+ of two. dist must be at most Length. */
+static Size_t bcastPos(const struct BcastRing_t *o, Size_t wpos, uint32_t dist)
+{
+    if(wpos >= dist)
+        return (Size_t)(wpos - dist);
+    else
+        return (Size_t)(o->Length - (dist - wpos));
+}
+
+/** Initialize broadcast ring struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to ring.
+ * @param buff Pointer to data buffer (must be length*item_size bytes long).
+ * @param length Number of items the ring holds.
+ * @param item_size Number of bytes per item.
+ */
+void BcastRing_init(struct BcastRing_t *o, void *buff, Size_t length, Size_t item_size)
+{
+    ASSERT(length != 0U);
+
+    o->ItemSize = item_size;
+    o->Length = length;
+    o->WritePos = 0U;
+    o->WriteSeq = 0U;
+    o->Seq = 0U;
+    o->Buff = (uint8_t*)buff;
+}
+
+/** Write an item to the ring, overwriting the oldest one if it is full.
+ *
+ * Note: Must be called only by the writer. Never waits for the readers.
+ *
+ * @param o Pointer to ring.
+ * @param val Pointer to item.
+ */
+void BcastRing_write(struct BcastRing_t *o, const void *val)
+{
+    Size_t pos;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ++(o->WriteSeq);
+        pos = o->WritePos;
+        if(++(o->WritePos) == o->Length)
+            o->WritePos = 0U;
+    }
+    CRITICAL_EXIT();
+
+    memcpy(&o->Buff[(size_t)pos * o->ItemSize], val, o->ItemSize);
+
+    CRITICAL_ENTER();
+    {
+        o->Seq = o->WriteSeq;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Attach a reader to the ring. The reader starts at the next item written.
+ *
+ * @param o Pointer to ring.
+ * @param r Pointer to reader.
+ */
+void BcastRing_attach(struct BcastRing_t *o, struct BcastReader_t *r)
+{
+    uint32_t wseq;
+    Size_t wpos;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        r->Seq = o->Seq;
+        wseq = o->WriteSeq;
+        wpos = o->WritePos;
+    }
+    CRITICAL_EXIT();
+
+    r->Pos = bcastPos(o, wpos, wseq - r->Seq);
+    r->Lost = 0U;
+}
+
+/** Read the next item of a reader.
+ *
+ * If the reader fell behind and its next items were overwritten, it skips to
+ * the oldest item in the ring and the skipped items are added to the count
+ * returned by BcastRing_lost().
+ *
+ * Note: Each reader must be used by only one context.
+ *
+ * @param o Pointer to ring.
+ * @param r Pointer to reader.
+ * @param val Pointer to where the item is copied.
+ * @return 1U upon success, 0U if there is no new item.
+ */
+uint8_t BcastRing_read(struct BcastRing_t *o, struct BcastReader_t *r, void *val)
+{
+    uint32_t seq;
+    uint32_t wseq;
+    Size_t wpos;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        seq = o->Seq;
+        wseq = o->WriteSeq;
+        wpos = o->WritePos;
+    }
+    CRITICAL_EXIT();
+
+    for(;;)
+    {
+        if(r->Seq == seq)
+            return 0U;
+
+        /* Items older than wseq-Length are (or are being) overwritten. */
+        if(wseq - r->Seq > o->Length)
+        {
+            r->Lost += wseq - r->Seq - o->Length;
+            r->Seq = wseq - o->Length;
+            r->Pos = bcastPos(o, wpos, o->Length);
+            continue;
+        }
+
+        memcpy(val, &o->Buff[(size_t)r->Pos * o->ItemSize], o->ItemSize);
+
+        CRITICAL_ENTER();
+        {
+            seq = o->Seq;
+            wseq = o->WriteSeq;
+            wpos = o->WritePos;
+        }
+        CRITICAL_EXIT();
+
+        if(wseq - r->Seq <= o->Length)
+            break;
+    }
+
+    ++(r->Seq);
+    if(++(r->Pos) == o->Length)
+        r->Pos = 0U;
+    return 1U;
+}
+
+/** Get the number of items a reader has to read.
+ *
+ * @param o Pointer to ring.
+ * @param r Pointer to reader.
+ * @return Number of items (at most the ring length).
+ */
+uint32_t BcastRing_available(struct BcastRing_t *o, const struct BcastReader_t *r)
+{
+    uint32_t num;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        num = o->Seq - r->Seq;
+    }
+    CRITICAL_EXIT();
+
+    return (num < o->Length) ? num : o->Length;
+}
+
+/** Get and clear the number of items a reader lost by overrun.
+ *
+ * @param r Pointer to reader.
+ * @return Number of items lost since the last call.
+ */
+uint32_t BcastRing_lost(struct BcastReader_t *r)
+{
+    uint32_t lost = r->Lost;
+    r->Lost = 0U;
+    return lost;
+}
+
+#endif /* BCASTRING_ENABLE */
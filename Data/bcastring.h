@@ -0,0 +1,68 @@
+/*
+ Arduinutil BcastRing - Broadcast ring buffer implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_BCASTRING_H__
+#define __ARDUINUTIL_BCASTRING_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (BCASTRING_ENABLE != 0)
+
+/* One writer, any number of readers. The writer always writes, overwriting the
+ oldest item, and never waits for the readers. Each reader has its own
+ BcastReader_t cursor; a reader that falls more than Length items behind
+ skips to the oldest item still in the ring and counts the lost ones.
+
+ Items are counted by WriteSeq (writes started) and Seq (writes finished). A
+ reader copies an item outside the critical section and then checks with
+ WriteSeq that the writer did not start overwriting it meanwhile. */
+struct BcastRing_t {
+    Size_t ItemSize;
+    Size_t Length;
+    Size_t WritePos;
+    uint32_t WriteSeq;
+    uint32_t Seq;
+    uint8_t *Buff;
+};
+
+struct BcastReader_t {
+    uint32_t Seq;
+    Size_t Pos;
+    uint32_t Lost;
+};
+
+void BcastRing_init(struct BcastRing_t *o, void *buff, Size_t length, Size_t item_size);
+void BcastRing_write(struct BcastRing_t *o, const void *val);
+void BcastRing_attach(struct BcastRing_t *o, struct BcastReader_t *r);
+uint8_t BcastRing_read(struct BcastRing_t *o, struct BcastReader_t *r, void *val);
+uint32_t BcastRing_available(struct BcastRing_t *o, const struct BcastReader_t *r);
+uint32_t BcastRing_lost(struct BcastReader_t *r);
+
+#endif /* BCASTRING_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_BCASTRING_H__ */
@@ -0,0 +1,292 @@
+/*
+ Arduinutil BipBuffer - Bipartite circular buffer implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Data/bipbuffer.h"
+#include <string.h>
+
+#if (BIPBUFFER_ENABLE != 0)
+
+/** Initialize bip-buffer struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to bip-buffer.
+ * @param buff Pointer to data buffer (must be size bytes long).
+ * @param size Number of bytes of the buffer.
+ */
+void BipBuffer_init(struct BipBuffer_t *o, void *buff, Size_t size)
+{
+    o->Size = size;
+    o->AStart = 0U;
+    o->AEnd = 0U;
+    o->BEnd = 0U;
+    o->BActive = 0U;
+    o->Reserved = 0U;
+    o->Buff = (uint8_t*)buff;
+}
+
+/** Reserve up to num contiguous bytes to be written in place.
+ *
+ * The bytes are written directly in the buffer starting at *ptr. They are
+ * inserted in the bip-buffer by BipBuffer_commit().
+ *
+ * Note: No other producer may insert bytes in the bip-buffer between
+ * BipBuffer_reserve() and BipBuffer_commit().
+ *
+ * @param o Pointer to bip-buffer.
+ * @param num Number of bytes wanted.
+ * @param ptr Pointer to where the address of the first byte is stored.
+ * @return Number of contiguous bytes reserved (at most num, 0U if the
+ * bip-buffer is full).
+ */
+Size_t BipBuffer_reserve(struct BipBuffer_t *o, Size_t num, uint8_t **ptr)
+{
+    Size_t start;
+    Size_t avail;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        if(o->BActive != 0U)
+        {
+            start = o->BEnd;
+            avail = o->AStart - o->BEnd;
+        }
+        else
+        {
+            if(o->AStart == o->AEnd)
+            {
+                /* Empty, start over at the beginning of the buffer. */
+                o->AStart = 0U;
+                o->AEnd = 0U;
+            }
+
+            avail = o->Size - o->AEnd;
+            if(avail >= num || avail >= o->AStart)
+            {
+                start = o->AEnd;
+            }
+            else
+            {
+                start = 0U;
+                avail = o->AStart;
+            }
+        }
+    }
+    CRITICAL_EXIT();
+
+    if(num > avail)
+        num = avail;
+    o->Reserved = start;
+    *ptr = &o->Buff[start];
+    return num;
+}
+
+/** Insert in the bip-buffer num bytes written in place.
+ *
+ * @param o Pointer to bip-buffer.
+ * @param num Number of bytes (at most the number reserved).
+ */
+void BipBuffer_commit(struct BipBuffer_t *o, Size_t num)
+{
+    CRITICAL_VAL();
+
+    if(num == 0U)
+        return;
+
+    CRITICAL_ENTER();
+    {
+        if(o->BActive != 0U)
+        {
+            ASSERT(o->Reserved == o->BEnd);
+            o->BEnd += num;
+        }
+        else if(o->Reserved == o->AEnd)
+        {
+            o->AEnd += num;
+        }
+        else if(o->AStart == o->AEnd)
+        {
+            /* Region B was reserved, but A was consumed meanwhile. */
+            o->AStart = 0U;
+            o->AEnd = num;
+        }
+        else
+        {
+            o->BEnd = num;
+            o->BActive = 1U;
+        }
+    }
+    CRITICAL_EXIT();
+}
+
+/** Get the contiguous bytes in the front of the bip-buffer to be read in
+ * place.
+ *
+ * The bytes are read directly from the buffer starting at *ptr. They are
+ * removed from the bip-buffer by BipBuffer_release(). Bytes written after
+ * the buffer wrapped are returned once these are released.
+ *
+ * Note: No other consumer may remove bytes from the bip-buffer between
+ * BipBuffer_peek() and BipBuffer_release().
+ *
+ * @param o Pointer to bip-buffer.
+ * @param ptr Pointer to where the address of the first byte is stored.
+ * @return Number of contiguous bytes (0U if the bip-buffer is empty).
+ */
+Size_t BipBuffer_peek(struct BipBuffer_t *o, uint8_t **ptr)
+{
+    Size_t num;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        num = o->AEnd - o->AStart;
+        *ptr = &o->Buff[o->AStart];
+    }
+    CRITICAL_EXIT();
+    return num;
+}
+
+/** Remove from the front of the bip-buffer num bytes read in place.
+ *
+ * @param o Pointer to bip-buffer.
+ * @param num Number of bytes (at most the number peeked).
+ */
+void BipBuffer_release(struct BipBuffer_t *o, Size_t num)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ASSERT(num <= o->AEnd - o->AStart);
+
+        o->AStart += num;
+        if(o->AStart == o->AEnd && o->BActive != 0U)
+        {
+            o->AStart = 0U;
+            o->AEnd = o->BEnd;
+            o->BEnd = 0U;
+            o->BActive = 0U;
+        }
+    }
+    CRITICAL_EXIT();
+}
+
+/** Copy up to num bytes to the bip-buffer.
+ *
+ * @param o Pointer to bip-buffer.
+ * @param buff Pointer to the bytes.
+ * @param num Number of bytes.
+ * @return Number of bytes inserted (less than num if the bip-buffer gets
+ * full).
+ */
+Size_t BipBuffer_write(struct BipBuffer_t *o, const void *buff, Size_t num)
+{
+    const uint8_t *src = (const uint8_t*)buff;
+    Size_t total = 0U;
+    uint8_t i;
+
+    /* The free space is in at most two pieces. */
+    for(i = 0U; i < 2U && total < num; ++i)
+    {
+        uint8_t *ptr;
+        Size_t n = BipBuffer_reserve(o, num - total, &ptr);
+        if(n == 0U)
+            break;
+        memcpy(ptr, &src[total], n);
+        BipBuffer_commit(o, n);
+        total += n;
+    }
+    return total;
+}
+
+/** Copy up to num bytes from the bip-buffer.
+ *
+ * @param o Pointer to bip-buffer.
+ * @param buff Pointer to where the bytes are copied.
+ * @param num Number of bytes.
+ * @return Number of bytes removed (less than num if the bip-buffer gets
+ * empty).
+ */
+Size_t BipBuffer_read(struct BipBuffer_t *o, void *buff, Size_t num)
+{
+    uint8_t *dst = (uint8_t*)buff;
+    Size_t total = 0U;
+    uint8_t i;
+
+    /* The data is in at most two regions. */
+    for(i = 0U; i < 2U && total < num; ++i)
+    {
+        uint8_t *ptr;
+        Size_t n = BipBuffer_peek(o, &ptr);
+        if(n == 0U)
+            break;
+        if(n > num - total)
+            n = num - total;
+        memcpy(&dst[total], ptr, n);
+        BipBuffer_release(o, n);
+        total += n;
+    }
+    return total;
+}
+
+/** Get the number of bytes in the bip-buffer.
+ *
+ * @param o Pointer to bip-buffer.
+ * @return Number of bytes in the bip-buffer.
+ */
+Size_t BipBuffer_used(const struct BipBuffer_t *o)
+{
+    Size_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = (o->AEnd - o->AStart) + o->BEnd;
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Remove all bytes from the bip-buffer.
+ *
+ * Note: Must not be called between BipBuffer_peek() and BipBuffer_release().
+ *
+ * @param o Pointer to bip-buffer.
+ */
+void BipBuffer_clear(struct BipBuffer_t *o)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        /* A reservation in progress is at AEnd or at BEnd, keep it valid. */
+        if(o->BActive != 0U)
+        {
+            o->AEnd = o->BEnd;
+            o->BEnd = 0U;
+            o->BActive = 0U;
+        }
+        o->AStart = o->AEnd;
+    }
+    CRITICAL_EXIT();
+}
+
+#endif /* BIPBUFFER_ENABLE */
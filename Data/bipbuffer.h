@@ -0,0 +1,65 @@
+/*
+ Arduinutil BipBuffer - Bipartite circular buffer implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_BIPBUFFER_H__
+#define __ARDUINUTIL_BIPBUFFER_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (BIPBUFFER_ENABLE != 0)
+
+/* The data is kept in up to two regions of the buffer: A, from AStart to
+ AEnd, is read first; B, from the start of the buffer to BEnd, is written
+ when there is more space before A than after it. When A is consumed B
+ becomes A. Therefore write and read regions never wrap: they are handed out
+ contiguous and can be given as a whole to a DMA or a bulk transfer. */
+struct BipBuffer_t {
+    Size_t Size;
+    volatile Size_t AStart;
+    volatile Size_t AEnd;
+    volatile Size_t BEnd;
+    volatile uint8_t BActive;
+    Size_t Reserved;
+    uint8_t *Buff;
+};
+
+void BipBuffer_init(struct BipBuffer_t *o, void *buff, Size_t size);
+Size_t BipBuffer_reserve(struct BipBuffer_t *o, Size_t num, uint8_t **ptr);
+void BipBuffer_commit(struct BipBuffer_t *o, Size_t num);
+Size_t BipBuffer_peek(struct BipBuffer_t *o, uint8_t **ptr);
+void BipBuffer_release(struct BipBuffer_t *o, Size_t num);
+Size_t BipBuffer_write(struct BipBuffer_t *o, const void *buff, Size_t num);
+Size_t BipBuffer_read(struct BipBuffer_t *o, void *buff, Size_t num);
+Size_t BipBuffer_used(const struct BipBuffer_t *o);
+void BipBuffer_clear(struct BipBuffer_t *o);
+
+#define BipBuffer_empty(o) (BipBuffer_used(o) == 0U)
+
+#endif /* BIPBUFFER_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_BIPBUFFER_H__ */
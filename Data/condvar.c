@@ -0,0 +1,142 @@
+/*
+ Arduinutil CondVar - Condition variable implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/condvar.h"
+#include "Data/wait.h"
+
+#if (CONDVAR_ENABLE != 0 && MUTEX_ENABLE != 0 && WAIT_ENABLE != 0)
+
+/* Take a notification, if there is one. If leave is not 0U the waiter stops
+ waiting even without a notification. */
+static uint8_t condVarTake(struct CondVar_t *o, uint8_t leave)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Signals != 0U;
+        if(ret)
+            --(o->Signals);
+        if(ret || leave != 0U)
+            --(o->Waiters);
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Initialize condition variable struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to condition variable.
+ */
+void CondVar_init(struct CondVar_t *o)
+{
+    o->Waiters = 0U;
+    o->Signals = 0U;
+}
+
+/** Unlock the mutex, wait for a notification and lock the mutex again.
+ *
+ * Note: Must be called with the mutex locked once by the caller and must not be
+ * called with interrupts disabled. The mutex is locked again also if the timeout
+ * expires.
+ *
+ * @param o Pointer to condition variable.
+ * @param mutex Pointer to mutex.
+ * @param timeout_ms Maximum time to wait in milliseconds (WAIT_FOREVER waits
+ * forever). See Wait_begin().
+ * @return 1U if notified, 0U if the timeout expired.
+ */
+uint8_t CondVar_wait(struct CondVar_t *o, struct Mutex_t *mutex, uint32_t timeout_ms)
+{
+    struct Wait_t w;
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    ASSERT(Mutex_getdepth(mutex) == 1U);
+
+    /* Register before unlocking, so a notify after the unlock is not lost. */
+    Wait_begin(&w, o, timeout_ms);
+    CRITICAL_ENTER();
+    {
+        ++(o->Waiters);
+    }
+    CRITICAL_EXIT();
+    Mutex_unlock(mutex);
+
+    while((ret = condVarTake(o, 0U)) == 0U && Wait_sleep(&w) != 0U)
+    {
+    }
+    if(ret == 0U)
+        ret = condVarTake(o, 1U);
+    Wait_end(&w);
+
+    (void)Mutex_lock_wait(mutex, WAIT_FOREVER);
+    return ret;
+}
+
+/** Wake one thread waiting for the condition variable.
+ *
+ * Note: Can be called with or without the mutex locked.
+ *
+ * @param o Pointer to condition variable.
+ */
+void CondVar_notifyone(struct CondVar_t *o)
+{
+    uint8_t wake;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        wake = o->Signals < o->Waiters;
+        if(wake)
+            ++(o->Signals);
+    }
+    CRITICAL_EXIT();
+
+    if(wake)
+        WAKE_OBJECT(o);
+}
+
+/** Wake all threads waiting for the condition variable.
+ *
+ * Note: Can be called with or without the mutex locked.
+ *
+ * @param o Pointer to condition variable.
+ */
+void CondVar_notifyall(struct CondVar_t *o)
+{
+    uint8_t wake;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        wake = o->Signals < o->Waiters;
+        o->Signals = o->Waiters;
+    }
+    CRITICAL_EXIT();
+
+    if(wake)
+        WAKE_OBJECT(o);
+}
+
+#endif /* CONDVAR_ENABLE && MUTEX_ENABLE && WAIT_ENABLE */
@@ -0,0 +1,64 @@
+/*
+ Arduinutil CondVar - Condition variable implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_CONDVAR_H__
+#define __ARDUINUTIL_CONDVAR_H__
+
+#include "Arduinutil.h"
+#include "Data/mutex.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CONDVAR_ENABLE != 0 && MUTEX_ENABLE != 0 && WAIT_ENABLE != 0)
+
+/* A condition variable lets a thread that holds a mutex sleep until another
+ thread changes the state the mutex protects:
+
+  Mutex_lock_wait(&lock, WAIT_FOREVER);
+  while(Queue_empty(&requests))
+      CondVar_wait(&changed, &lock, WAIT_FOREVER);
+  ...
+  Mutex_unlock(&lock);
+
+ CondVar_wait() unlocks the mutex, sleeps (see Data/wait.h) and locks it again
+ before returning. Waiters counts the sleeping threads and Signals the ones
+ notified that did not wake yet. As with other condition variables, a notify
+ wakes threads waiting at that time, the state must be checked again after the
+ wait and a waiter that starts waiting after a notify may take it. */
+struct CondVar_t {
+    volatile Size_t Waiters;
+    volatile Size_t Signals;
+};
+
+void CondVar_init(struct CondVar_t *o);
+uint8_t CondVar_wait(struct CondVar_t *o, struct Mutex_t *mutex, uint32_t timeout_ms);
+void CondVar_notifyone(struct CondVar_t *o);
+void CondVar_notifyall(struct CondVar_t *o);
+
+#endif /* CONDVAR_ENABLE && MUTEX_ENABLE && WAIT_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_CONDVAR_H__ */
@@ -0,0 +1,158 @@
+/*
+ Arduinutil EventGroup - Event flag group implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/eventgroup.h"
+#include "Data/wait.h"
+
+#if (EVENTGROUP_ENABLE != 0)
+
+/** Initialize event group struct with all flags cleared.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to event group.
+ */
+void EventGroup_init(struct EventGroup_t *o)
+{
+    o->Bits = 0U;
+}
+
+/** Set flags.
+ *
+ * Note: Can be called by interrupt handlers.
+ *
+ * @param o Pointer to event group.
+ * @param bits Flags to set.
+ * @return Flags after setting.
+ */
+uint32_t EventGroup_set(struct EventGroup_t *o, uint32_t bits)
+{
+    uint32_t old;
+    uint32_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        old = o->Bits;
+        ret = old | bits;
+        o->Bits = ret;
+    }
+    CRITICAL_EXIT();
+
+    if(ret != old)
+        WAKE_OBJECT(o);
+    return ret;
+}
+
+/** Clear flags.
+ *
+ * @param o Pointer to event group.
+ * @param bits Flags to clear.
+ * @return Flags before clearing.
+ */
+uint32_t EventGroup_clear(struct EventGroup_t *o, uint32_t bits)
+{
+    uint32_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Bits;
+        o->Bits = ret & ~bits;
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Get flags.
+ *
+ * @param o Pointer to event group.
+ * @return Flags set.
+ */
+uint32_t EventGroup_get(const struct EventGroup_t *o)
+{
+    uint32_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Bits;
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Check flags without waiting.
+ *
+ * @param o Pointer to event group.
+ * @param bits Flags to check.
+ * @param mode EVENTGROUP_ANY or EVENTGROUP_ALL, optionally or'ed with
+ * EVENTGROUP_CLEAR to clear the flags returned.
+ * @return The flags of bits that are set if the condition is met (any or all
+ * of bits set), 0U otherwise.
+ */
+uint32_t EventGroup_poll(struct EventGroup_t *o, uint32_t bits, uint8_t mode)
+{
+    uint32_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Bits & bits;
+        if((mode & EVENTGROUP_ALL) != 0U && ret != bits)
+            ret = 0U;
+        if((mode & EVENTGROUP_CLEAR) != 0U)
+            o->Bits &= ~ret;
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+#if (WAIT_ENABLE != 0)
+
+/** Wait for flags.
+ *
+ * Note: Must not be called with interrupts disabled.
+ *
+ * @param o Pointer to event group.
+ * @param bits Flags to wait for.
+ * @param mode EVENTGROUP_ANY or EVENTGROUP_ALL, optionally or'ed with
+ * EVENTGROUP_CLEAR to clear the flags returned. See EventGroup_poll().
+ * @param timeout_ms Maximum time to wait in milliseconds (WAIT_FOREVER waits
+ * forever). See Wait_begin().
+ * @return The flags of bits that are set, 0U if the timeout expired.
+ */
+uint32_t EventGroup_wait(struct EventGroup_t *o, uint32_t bits, uint8_t mode,
+        uint32_t timeout_ms)
+{
+    struct Wait_t w;
+    uint32_t ret;
+
+    Wait_begin(&w, o, timeout_ms);
+    while((ret = EventGroup_poll(o, bits, mode)) == 0U && Wait_sleep(&w) != 0U)
+    {
+    }
+    Wait_end(&w);
+    return ret;
+}
+
+#endif /* WAIT_ENABLE */
+
+#endif /* EVENTGROUP_ENABLE */
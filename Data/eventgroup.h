@@ -0,0 +1,68 @@
+/*
+ Arduinutil EventGroup - Event flag group implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_EVENTGROUP_H__
+#define __ARDUINUTIL_EVENTGROUP_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (EVENTGROUP_ENABLE != 0)
+
+/* Up to 32 event flags in one word. Interrupt handlers and threads set flags
+ with EventGroup_set(); a consumer checks or waits for any or all of a set of
+ flags, optionally clearing the ones it got, so one call covers several event
+ sources:
+
+  bits = EventGroup_wait(&events, EV_RX | EV_I2C | EV_ADC,
+          EVENTGROUP_ANY | EVENTGROUP_CLEAR, WAIT_FOREVER);
+
+ Flags are changed in critical sections and setting flags wakes the waiters
+ (WAKE_OBJECT()). */
+struct EventGroup_t {
+    volatile uint32_t Bits;
+};
+
+/* Modes of EventGroup_poll() and EventGroup_wait(). */
+#define EVENTGROUP_ANY   0x00U /* Any of the flags is set. */
+#define EVENTGROUP_ALL   0x01U /* All the flags are set. */
+#define EVENTGROUP_CLEAR 0x02U /* Clear the flags returned. */
+
+void EventGroup_init(struct EventGroup_t *o);
+uint32_t EventGroup_set(struct EventGroup_t *o, uint32_t bits);
+uint32_t EventGroup_clear(struct EventGroup_t *o, uint32_t bits);
+uint32_t EventGroup_get(const struct EventGroup_t *o);
+uint32_t EventGroup_poll(struct EventGroup_t *o, uint32_t bits, uint8_t mode);
+#if (WAIT_ENABLE != 0)
+    uint32_t EventGroup_wait(struct EventGroup_t *o, uint32_t bits, uint8_t mode,
+            uint32_t timeout_ms);
+#endif
+
+#endif /* EVENTGROUP_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_EVENTGROUP_H__ */
@@ -0,0 +1,114 @@
+/*
+ Arduinutil LfStack - Lock-free stack implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/lfstack.h"
+
+#if (LFSTACK_ENABLE != 0)
+
+/* Next is read by a thread popping a node while another thread that popped it
+ first may already push it again and change it; the compare-and-swap of Top
+ discards the value read then. Next is accessed with relaxed atomics so that
+ this race is well defined. The release/acquire orders of Top make the data of
+ a node written before its push visible to the thread that pops it. */
+#define LOAD_RELAXED(ptr)       __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define STORE_RELAXED(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+#define CAS_RELEASE(ptr, expected, val) \
+    __atomic_compare_exchange_n(ptr, expected, val, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED)
+#define CAS_ACQUIRE(ptr, expected, val) \
+    __atomic_compare_exchange_n(ptr, expected, val, 1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)
+
+#define TOP_NODE(top) ((uint32_t)(top))
+#define TOP_MAKE(top, node) ((((top) >> 32U) + 1U) << 32U | (uint64_t)(node))
+
+/** Initialize stack struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to stack.
+ * @param next Pointer to the links (must be length uint32_t long).
+ * @param length Number of indexes.
+ * @param full 1U to push all indexes (0 on the top), 0U to start empty.
+ */
+void LfStack_init(struct LfStack_t *o, uint32_t *next, Size_t length, uint8_t full)
+{
+    Size_t i;
+
+    ASSERT(length != 0U && length < 0xFFFFFFFFUL);
+
+    o->Next = next;
+    o->Length = length;
+    o->Top = 0U;
+    if(full != 0U)
+    {
+        for(i = 0U; i < length; ++i)
+            next[i] = (uint32_t)(i + 2U);
+        next[length - 1U] = 0U;
+        o->Top = 1U;
+    }
+}
+
+/** Push an index on the top of the stack.
+ *
+ * @param o Pointer to stack.
+ * @param index Index to push (less than the length, not in the stack).
+ */
+void LfStack_push(struct LfStack_t *o, Size_t index)
+{
+    uint64_t top = LOAD_RELAXED(&o->Top);
+
+    ASSERT(index < o->Length);
+
+    do {
+        STORE_RELAXED(&o->Next[index], TOP_NODE(top));
+    } while(!CAS_RELEASE(&o->Top, &top, TOP_MAKE(top, index + 1U)));
+}
+
+/** Pop the index on the top of the stack.
+ *
+ * @param o Pointer to stack.
+ * @return Index popped, LFSTACK_EMPTY if the stack is empty.
+ */
+Size_t LfStack_pop(struct LfStack_t *o)
+{
+    uint64_t top = LOAD_ACQUIRE(&o->Top);
+    uint32_t node;
+
+    do {
+        node = TOP_NODE(top);
+        if(node == 0U)
+            return LFSTACK_EMPTY;
+    } while(!CAS_ACQUIRE(&o->Top, &top,
+            TOP_MAKE(top, LOAD_RELAXED(&o->Next[node - 1U]))));
+
+    return (Size_t)(node - 1U);
+}
+
+/** Check if the stack is empty.
+ *
+ * @param o Pointer to stack.
+ * @return 1U if the stack is empty, 0U otherwise.
+ */
+uint8_t LfStack_empty(const struct LfStack_t *o)
+{
+    return TOP_NODE(LOAD_RELAXED(&o->Top)) == 0U;
+}
+
+#endif /* LFSTACK_ENABLE */
@@ -0,0 +1,60 @@
+/*
+ Arduinutil LfStack - Lock-free stack implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_LFSTACK_H__
+#define __ARDUINUTIL_LFSTACK_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (LFSTACK_ENABLE != 0)
+
+/* Lock-free LIFO stack of the indexes 0 to Length-1 (Treiber stack), for
+ example a free list of buffers: index i is the block at buff + i * size.
+
+ Next[i] links node i to the node below it, both stored as index plus one so
+ that 0 is the end of the stack. Top holds the first node in its low 32 bits
+ and a generation in its high 32 bits, incremented by every push and pop. A
+ compare-and-swap of Top then fails if another thread popped and pushed the
+ same node meanwhile (the ABA problem), since the generation changed. */
+struct LfStack_t {
+    volatile uint64_t Top;
+    uint32_t *Next;
+    Size_t Length;
+};
+
+#define LFSTACK_EMPTY ((Size_t)-1)
+
+void LfStack_init(struct LfStack_t *o, uint32_t *next, Size_t length, uint8_t full);
+void LfStack_push(struct LfStack_t *o, Size_t index);
+Size_t LfStack_pop(struct LfStack_t *o);
+uint8_t LfStack_empty(const struct LfStack_t *o);
+
+#endif /* LFSTACK_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_LFSTACK_H__ */
@@ -18,9 +18,28 @@ limitations under the License.
 */
 
 #include "Data/mailbox.h"
+#include "Data/wait.h"
 
 #if (MAILBOX_ENABLE != 0)
 
+#if (MAILBOX_CAS_ENABLE != 0)
+/* Sending takes a slot only if it is empty (compare-and-swap NULL to msg) and
+ receiving empties it with an exchange, so a slot is never lost or taken
+ twice. The acquire/release orders make the message contents written before
+ the send visible to the receiver. */
+#define EXCHANGE(ptr, msg) __atomic_exchange_n(ptr, msg, __ATOMIC_ACQ_REL)
+#define LOAD_RELAXED(ptr)  __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define STORE_RELAXED(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+
+/* Put msg in the slot if it is empty. */
+static uint8_t mailboxCasNull(void *volatile *slot, void *msg)
+{
+    void *expected = NULL;
+    return __atomic_compare_exchange_n(slot, &expected, msg, 0,
+            __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+#endif
+
 /** Initialize mailbox struct.
  *
  * Note: Not thread-safe.
@@ -41,6 +60,9 @@ void Mailbox_init(struct Mailbox_t *o)
 uint8_t Mailbox_send(struct Mailbox_t *o, void *msg)
 {
     uint8_t ret;
+#if (MAILBOX_CAS_ENABLE != 0)
+    ret = mailboxCasNull(&o->Msg, msg);
+#else
     CRITICAL_VAL();
 
     CRITICAL_ENTER();
@@ -52,6 +74,40 @@ uint8_t Mailbox_send(struct Mailbox_t *o, void *msg)
         }
     }
     CRITICAL_EXIT();
+#endif
+
+    if(ret)
+        WAKE_OBJECT(o);
+    return ret;
+}
+
+/** Send message to mailbox, replacing the message it holds.
+ *
+ * For producers that always have a new value, such as a sampling interrupt:
+ * the receiver gets only the latest message and the replaced one can be
+ * recycled by the sender.
+ *
+ * @param o Pointer to mailbox.
+ * @param msg Pointer to the message.
+ * @return Pointer to the replaced message, NULL if the mailbox was empty.
+ */
+void *Mailbox_send_overwrite(struct Mailbox_t *o, void *msg)
+{
+    void *ret;
+#if (MAILBOX_CAS_ENABLE != 0)
+    ret = EXCHANGE(&o->Msg, msg);
+#else
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Msg;
+        o->Msg = msg;
+    }
+    CRITICAL_EXIT();
+#endif
+
+    WAKE_OBJECT(o);
     return ret;
 }
 
@@ -63,6 +119,11 @@ uint8_t Mailbox_send(struct Mailbox_t *o, void *msg)
 void *Mailbox_receive(struct Mailbox_t *o)
 {
     void *ret;
+#if (MAILBOX_CAS_ENABLE != 0)
+    if(LOAD_RELAXED(&o->Msg) == NULL)
+        return NULL;
+    ret = EXCHANGE(&o->Msg, NULL);
+#else
     CRITICAL_VAL();
 
     CRITICAL_ENTER();
@@ -71,6 +132,133 @@ void *Mailbox_receive(struct Mailbox_t *o)
         o->Msg = NULL;
     }
     CRITICAL_EXIT();
+#endif
+    return ret;
+}
+
+/** Initialize multi-slot mailbox struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to mailbox.
+ * @param slots Pointer to the slots (must be length pointers long).
+ * @param length Number of messages the mailbox holds.
+ */
+void MultiMailbox_init(struct MultiMailbox_t *o, void **slots, Size_t length)
+{
+    Size_t i;
+
+    ASSERT(length != 0U);
+
+    o->Length = length;
+    o->SendPos = 0U;
+    o->RecvPos = 0U;
+    o->Slots = (void *volatile *)slots;
+    for(i = 0U; i < length; ++i)
+        o->Slots[i] = NULL;
+}
+
+/** Send message to multi-slot mailbox.
+ *
+ * @param o Pointer to mailbox.
+ * @param msg Pointer to the message (not NULL).
+ * @return 1U upon success, 0U if all slots are used.
+ */
+uint8_t MultiMailbox_send(struct MultiMailbox_t *o, void *msg)
+{
+    Size_t pos;
+    Size_t i;
+    uint8_t ret = 0U;
+#if (MAILBOX_CAS_ENABLE == 0)
+    CRITICAL_VAL();
+#endif
+
+    ASSERT(msg != NULL);
+
+#if (MAILBOX_CAS_ENABLE != 0)
+    pos = LOAD_RELAXED(&o->SendPos);
+    for(i = 0U; i < o->Length; ++i)
+    {
+        if(LOAD_RELAXED(&o->Slots[pos]) == NULL && mailboxCasNull(&o->Slots[pos], msg))
+        {
+            ret = 1U;
+            break;
+        }
+        if(++pos == o->Length)
+            pos = 0U;
+    }
+    if(ret)
+        STORE_RELAXED(&o->SendPos, (pos + 1U == o->Length) ? 0U : pos + 1U);
+#else
+    CRITICAL_ENTER();
+    {
+        pos = o->SendPos;
+        for(i = 0U; i < o->Length; ++i)
+        {
+            if(o->Slots[pos] == NULL)
+            {
+                o->Slots[pos] = msg;
+                o->SendPos = (pos + 1U == o->Length) ? 0U : pos + 1U;
+                ret = 1U;
+                break;
+            }
+            if(++pos == o->Length)
+                pos = 0U;
+        }
+    }
+    CRITICAL_EXIT();
+#endif
+
+    if(ret)
+        WAKE_OBJECT(o);
+    return ret;
+}
+
+/** Read message from multi-slot mailbox.
+ *
+ * @param o Pointer to mailbox.
+ * @return Pointer to a message upon success, NULL if all slots are empty.
+ */
+void *MultiMailbox_receive(struct MultiMailbox_t *o)
+{
+    Size_t pos;
+    Size_t i;
+    void *ret = NULL;
+#if (MAILBOX_CAS_ENABLE != 0)
+    pos = LOAD_RELAXED(&o->RecvPos);
+    for(i = 0U; i < o->Length; ++i)
+    {
+        if(LOAD_RELAXED(&o->Slots[pos]) != NULL
+                && (ret = EXCHANGE(&o->Slots[pos], NULL)) != NULL)
+        {
+            break;
+        }
+        if(++pos == o->Length)
+            pos = 0U;
+    }
+    if(ret != NULL)
+        STORE_RELAXED(&o->RecvPos, (pos + 1U == o->Length) ? 0U : pos + 1U);
+#else
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        pos = o->RecvPos;
+        for(i = 0U; i < o->Length; ++i)
+        {
+            ret = o->Slots[pos];
+            if(ret != NULL)
+            {
+                o->Slots[pos] = NULL;
+                o->RecvPos = (pos + 1U == o->Length) ? 0U : pos + 1U;
+                break;
+            }
+            if(++pos == o->Length)
+                pos = 0U;
+        }
+    }
+    CRITICAL_EXIT();
+#endif
     return ret;
 }
 
@@ -35,8 +35,26 @@ struct Mailbox_t {
 
 void Mailbox_init(struct Mailbox_t *o);
 uint8_t Mailbox_send(struct Mailbox_t *o, void *msg);
+void *Mailbox_send_overwrite(struct Mailbox_t *o, void *msg);
 void *Mailbox_receive(struct Mailbox_t *o);
 
+/* A mailbox with several slots, each holding a message or NULL. Send puts the
+ message in a free slot and receive takes one from a used slot; both search
+ from where the last one stopped, so with one sender and one receiver messages
+ are usually received in the order sent, but the order is not guaranteed.
+ With MAILBOX_CAS_ENABLE the slots are changed with compare-and-swap and
+ exchange, without critical sections. */
+struct MultiMailbox_t {
+    Size_t Length;
+    volatile Size_t SendPos;
+    volatile Size_t RecvPos;
+    void *volatile *Slots;
+};
+
+void MultiMailbox_init(struct MultiMailbox_t *o, void **slots, Size_t length);
+uint8_t MultiMailbox_send(struct MultiMailbox_t *o, void *msg);
+void *MultiMailbox_receive(struct MultiMailbox_t *o);
+
 #endif /* MAILBOX_ENABLE */
 
 #ifdef __cplusplus
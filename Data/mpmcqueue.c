@@ -0,0 +1,188 @@
+/*
+ Arduinutil MpmcQueue - Multiple-producer multiple-consumer queue implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/mpmcqueue.h"
+#include <string.h>
+
+#if (MPMCQUEUE_ENABLE != 0)
+
+#define LOAD_RELAXED(ptr)       __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define CAS_RELAXED(ptr, expected, val) \
+    __atomic_compare_exchange_n(ptr, expected, val, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+
+static Size_t *mpmcSeq(const struct MpmcQueue_t *o, Size_t pos)
+{
+    return (Size_t*)&o->Buff[(pos & o->Mask) * o->SlotSize];
+}
+
+static uint8_t *mpmcItem(Size_t *seq)
+{
+    return (uint8_t*)&seq[1];
+}
+
+/** Initialize queue struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to data buffer (must be MPMCQUEUE_BUFSZ(length, item_size)
+ * bytes long and aligned to Size_t).
+ * @param length Number of items the queue can hold (must be a power of two).
+ * @param item_size Number of bytes per item.
+ */
+void MpmcQueue_init(struct MpmcQueue_t *o, void *buff, Size_t length, Size_t item_size)
+{
+    Size_t i;
+
+    ASSERT(length != 0U && (length & (length - 1U)) == 0U);
+
+    o->ItemSize = item_size;
+    o->SlotSize = MPMCQUEUE_SLOTSZ(item_size);
+    o->Mask = length - 1U;
+    o->Buff = (uint8_t*)buff;
+    o->Tail = 0U;
+    o->Head = 0U;
+
+    for(i = 0U; i < length; ++i)
+        *mpmcSeq(o, i) = i;
+}
+
+/** Insert item in the back of the queue.
+ *
+ * @param o Pointer to queue.
+ * @param val Pointer to item.
+ * @return 1U upon success, 0U otherwise.
+ */
+uint8_t MpmcQueue_pushback(struct MpmcQueue_t *o, const void *val)
+{
+    Size_t pos = LOAD_RELAXED(&o->Tail);
+    Size_t *seq;
+
+    for(;;)
+    {
+        intptr_t diff;
+
+        seq = mpmcSeq(o, pos);
+        diff = (intptr_t)(LOAD_ACQUIRE(seq) - pos);
+
+        if(diff == 0)
+        {
+            /* Slot free: claim the position. */
+            if(CAS_RELAXED(&o->Tail, &pos, pos + 1U))
+                break;
+        }
+        else if(diff < 0)
+        {
+            return 0U; /* Full. */
+        }
+        else
+        {
+            pos = LOAD_RELAXED(&o->Tail); /* Another producer took it. */
+        }
+    }
+
+    memcpy(mpmcItem(seq), val, o->ItemSize);
+    STORE_RELEASE(seq, pos + 1U);
+    return 1U;
+}
+
+/** Remove item in the front of the queue.
+ *
+ * @param o Pointer to queue.
+ * @param val Pointer to item.
+ * @return 1U upon success, 0U otherwise.
+ */
+uint8_t MpmcQueue_popfront(struct MpmcQueue_t *o, void *val)
+{
+    Size_t pos = LOAD_RELAXED(&o->Head);
+    Size_t *seq;
+
+    for(;;)
+    {
+        intptr_t diff;
+
+        seq = mpmcSeq(o, pos);
+        diff = (intptr_t)(LOAD_ACQUIRE(seq) - (pos + 1U));
+
+        if(diff == 0)
+        {
+            /* Slot written: claim the position. */
+            if(CAS_RELAXED(&o->Head, &pos, pos + 1U))
+                break;
+        }
+        else if(diff < 0)
+        {
+            return 0U; /* Empty. */
+        }
+        else
+        {
+            pos = LOAD_RELAXED(&o->Head); /* Another consumer took it. */
+        }
+    }
+
+    memcpy(val, mpmcItem(seq), o->ItemSize);
+    STORE_RELEASE(seq, pos + o->Mask + 1U);
+    return 1U;
+}
+
+/** Get the queue length.
+ *
+ * @param o Pointer to queue.
+ * @return Length of the queue.
+ */
+Size_t MpmcQueue_length(const struct MpmcQueue_t *o)
+{
+    return o->Mask + 1U;
+}
+
+/** Get the number of used positions of the queue.
+ *
+ * Note: The value is a snapshot and counts positions claimed by producers
+ * that are still copying their items.
+ *
+ * @param o Pointer to queue.
+ * @return Number of used positions of the queue.
+ */
+Size_t MpmcQueue_used(const struct MpmcQueue_t *o)
+{
+    Size_t head = LOAD_ACQUIRE(&o->Head);
+    Size_t tail = LOAD_ACQUIRE(&o->Tail);
+    Size_t used = tail - head;
+
+    /* Head is read first, so Tail may have advanced by more than the length
+     in the meantime. */
+    return (used > o->Mask + 1U) ? (o->Mask + 1U) : used;
+}
+
+/** Get the number of free positions of the queue.
+ *
+ * Note: The value is a snapshot.
+ *
+ * @param o Pointer to queue.
+ * @return Number of free positions of the queue.
+ */
+Size_t MpmcQueue_free(const struct MpmcQueue_t *o)
+{
+    return MpmcQueue_length(o) - MpmcQueue_used(o);
+}
+
+#endif /* MPMCQUEUE_ENABLE */
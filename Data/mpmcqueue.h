@@ -0,0 +1,76 @@
+/*
+ Arduinutil MpmcQueue - Multiple-producer multiple-consumer queue implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_MPMCQUEUE_H__
+#define __ARDUINUTIL_MPMCQUEUE_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (MPMCQUEUE_ENABLE != 0)
+
+#define MPMCQUEUE_CACHE_LINE 64U
+
+/* Size of a slot: the sequence number followed by the item, rounded up to keep
+ the next sequence number aligned. */
+#define MPMCQUEUE_SLOTSZ(item_size) \
+    ((sizeof(Size_t) + (item_size) + sizeof(Size_t) - 1U) / sizeof(Size_t) * sizeof(Size_t))
+
+/* Size of the buffer for length items of item_size bytes. */
+#define MPMCQUEUE_BUFSZ(length, item_size) \
+    ((length) * MPMCQUEUE_SLOTSZ(item_size))
+
+/* Each slot has a sequence number that tells whether it is ready to be written
+ (equal to the Tail position) or read (equal to the Head position plus one).
+ Producers and consumers claim positions by compare-and-swap of Tail and Head,
+ which are kept in different cache lines. */
+struct MpmcQueue_t {
+    Size_t ItemSize;
+    Size_t SlotSize;
+    Size_t Mask;
+    uint8_t *Buff;
+    volatile Size_t Tail __attribute__((aligned(MPMCQUEUE_CACHE_LINE)));
+    volatile Size_t Head __attribute__((aligned(MPMCQUEUE_CACHE_LINE)));
+    uint8_t Pad[MPMCQUEUE_CACHE_LINE - sizeof(Size_t)];
+};
+
+void MpmcQueue_init(struct MpmcQueue_t *o, void *buff, Size_t length, Size_t item_size);
+uint8_t MpmcQueue_pushback(struct MpmcQueue_t *o, const void *val);
+uint8_t MpmcQueue_popfront(struct MpmcQueue_t *o, void *val);
+Size_t MpmcQueue_length(const struct MpmcQueue_t *o);
+Size_t MpmcQueue_used(const struct MpmcQueue_t *o);
+Size_t MpmcQueue_free(const struct MpmcQueue_t *o);
+
+#define MpmcQueue_write(o, val)    MpmcQueue_pushback(o, val)
+#define MpmcQueue_read(o, val)     MpmcQueue_popfront(o, val)
+#define MpmcQueue_empty(o)         (MpmcQueue_used(o) == 0U)
+#define MpmcQueue_full(o)          (MpmcQueue_free(o) == 0U)
+
+#endif /* MPMCQUEUE_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_MPMCQUEUE_H__ */
@@ -18,10 +18,86 @@
  */
 
 #include "Data/mutex.h"
+#include "Data/wait.h"
 #include <string.h>
 
 #if (MUTEX_ENABLE != 0)
 
+/* The mutex is a binary semaphore plus its owner. Owner, Depth and the
+ statistics are changed only by the owner: after taking the semaphore and
+ before giving it back. A thread can therefore tell if it holds the mutex by
+ comparing Owner with its own THREAD_ID(). */
+
+#if (MUTEX_STATS_ENABLE != 0)
+
+static void mutexHistAdd(uint32_t *hist, uint64_t t)
+{
+    uint8_t bin = 0U;
+    while(t > 1U && bin < MUTEX_HIST_BINS - 1U)
+    {
+        t >>= 1U;
+        ++bin;
+    }
+    ++hist[bin];
+}
+
+#endif /* MUTEX_STATS_ENABLE */
+
+/* Record a lock by self. If contended is not 0U, the thread waited since start
+ (STATS_CLOCK_NS()). */
+static void mutexLocked(struct Mutex_t *o, uintptr_t self, uint8_t contended,
+        uint64_t start)
+{
+#if (MUTEX_PRIO_ENABLE != 0)
+    uint8_t prio;
+    CRITICAL_VAL();
+
+    /* A waiter that came between the semaphore and the owner could not raise
+     the owner. */
+    CRITICAL_ENTER();
+    {
+        o->Owner = self;
+        prio = o->WaitPrio;
+    }
+    CRITICAL_EXIT();
+    if(prio != 0U)
+        MUTEX_PRIO_INHERIT(self, prio);
+#else
+    o->Owner = self;
+#endif
+    o->Depth = 1U;
+
+#if (MUTEX_STATS_ENABLE != 0)
+    {
+        uint64_t now = STATS_CLOCK_NS();
+
+        o->LockedNs = now;
+        ++o->Stats.Locks;
+        if(contended != 0U)
+        {
+            uint64_t wait = now - start;
+            ++o->Stats.Contended;
+            o->Stats.WaitNs += wait;
+            if(wait > o->Stats.MaxWaitNs)
+                o->Stats.MaxWaitNs = wait;
+            mutexHistAdd(o->Stats.WaitHist, wait);
+        }
+    }
+#else
+    (void)contended;
+    (void)start;
+#endif
+}
+
+/* Lock again a mutex held by the caller. */
+static uint8_t mutexRelock(struct Mutex_t *o)
+{
+    if(o->Recursive == 0U)
+        return 0U; /* Would deadlock. */
+    ++o->Depth;
+    return 1U;
+}
+
 /** Initialize mutex struct.
  *
  * Note: Not thread-safe.
@@ -32,26 +108,239 @@ void Mutex_init(struct Mutex_t *o)
 {
     Semaphore_init(&o->sem, 1U);
     Semaphore_unlock(&o->sem);
+    o->Owner = 0U;
+    o->Depth = 0U;
+    o->Recursive = 0U;
+#if (MUTEX_PRIO_ENABLE != 0)
+    o->WaitPrio = 0U;
+#endif
+#if (MUTEX_STATS_ENABLE != 0)
+    o->LockedNs = 0U;
+    Mutex_resetstats(o);
+#endif
+}
+
+/** Initialize mutex struct as a recursive mutex, which the owner can lock
+ * again. It is unlocked when it is unlocked as many times as it was locked.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to mutex.
+ */
+void Mutex_initrecursive(struct Mutex_t *o)
+{
+    Mutex_init(o);
+    o->Recursive = 1U;
 }
 
 /** Lock mutex.
  *
  * @param o Pointer to mutex.
- * @return 1U upon success, 0U otherwise.
+ * @return 1U upon success, 0U if the mutex is held by another thread or if it
+ * is held by the caller and is not recursive.
  */
 uint8_t Mutex_lock(struct Mutex_t *o)
 {
-    return Semaphore_lock(&o->sem);
+    uintptr_t self = THREAD_ID();
+
+    if(o->Owner == self)
+        return mutexRelock(o);
+    if(Semaphore_lock(&o->sem) == 0U)
+        return 0U;
+    mutexLocked(o, self, 0U, 0U);
+    return 1U;
+}
+
+#if (WAIT_ENABLE != 0)
+
+#if (MUTEX_PRIO_ENABLE != 0)
+
+/* Raise the owner to the priority of a waiter. */
+static void mutexInherit(struct Mutex_t *o, uint8_t prio)
+{
+    uintptr_t owner = 0U;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        if(prio > o->WaitPrio)
+        {
+            o->WaitPrio = prio;
+            owner = o->Owner;
+        }
+    }
+    CRITICAL_EXIT();
+    if(owner != 0U)
+        MUTEX_PRIO_INHERIT(owner, prio);
+}
+
+#endif /* MUTEX_PRIO_ENABLE */
+
+/** Lock mutex, waiting for it to be unlocked if needed.
+ *
+ * While waiting, the owner inherits the priority of the caller (see
+ * MUTEX_PRIO_INHERIT).
+ *
+ * Note: Must not be called with interrupts disabled.
+ *
+ * @param o Pointer to mutex.
+ * @param timeout_ms Maximum time to wait in milliseconds (WAIT_FOREVER waits
+ * forever). See Wait_begin().
+ * @return 1U upon success, 0U if the timeout expired or if the mutex is held by
+ * the caller and is not recursive.
+ */
+uint8_t Mutex_lock_wait(struct Mutex_t *o, uint32_t timeout_ms)
+{
+    uintptr_t self = THREAD_ID();
+    uint64_t start = 0U;
+    struct Wait_t w;
+    uint8_t ret;
+
+    if(o->Owner == self)
+        return mutexRelock(o);
+
+    /* No timeout: just try (and spin, see Semaphore_lock_wait()). */
+    if(Semaphore_lock_wait(&o->sem, 0U) != 0U)
+    {
+        mutexLocked(o, self, 0U, 0U);
+        return 1U;
+    }
+
+#if (MUTEX_STATS_ENABLE != 0)
+    start = STATS_CLOCK_NS();
+#endif
+
+    Wait_begin(&w, &o->sem, timeout_ms);
+    while((ret = Semaphore_lock(&o->sem)) == 0U)
+    {
+#if (MUTEX_PRIO_ENABLE != 0)
+        mutexInherit(o, THREAD_PRIO());
+#endif
+        if(Wait_sleep(&w) == 0U)
+            break;
+    }
+    Wait_end(&w);
+
+    if(ret != 0U)
+        mutexLocked(o, self, 1U, start);
+    return ret;
 }
 
+#endif /* WAIT_ENABLE */
+
 /** Unlock mutex.
  *
  * @param o Pointer to mutex.
- * @return 1U upon success, 0U otherwise.
+ * @return 1U upon success, 0U if the mutex is not held by the caller.
  */
 uint8_t Mutex_unlock(struct Mutex_t *o)
 {
+    uintptr_t self = THREAD_ID();
+
+    if(o->Owner != self)
+        return 0U;
+    if(--(o->Depth) != 0U)
+        return 1U;
+
+#if (MUTEX_STATS_ENABLE != 0)
+    {
+        uint64_t hold = STATS_CLOCK_NS() - o->LockedNs;
+
+        o->Stats.HoldNs += hold;
+        if(hold > o->Stats.MaxHoldNs)
+            o->Stats.MaxHoldNs = hold;
+        mutexHistAdd(o->Stats.HoldHist, hold);
+    }
+#endif
+
+#if (MUTEX_PRIO_ENABLE != 0)
+    {
+        uint8_t prio;
+        CRITICAL_VAL();
+
+        /* The waiters raise the next owner when they wake. */
+        CRITICAL_ENTER();
+        {
+            prio = o->WaitPrio;
+            o->WaitPrio = 0U;
+            o->Owner = 0U;
+        }
+        CRITICAL_EXIT();
+        if(prio != 0U)
+            MUTEX_PRIO_RESTORE(self);
+    }
+#else
+    o->Owner = 0U;
+#endif
+
     return Semaphore_unlock(&o->sem);
 }
 
+/** Get the owner of the mutex.
+ *
+ * @param o Pointer to mutex.
+ * @return THREAD_ID() of the thread that holds the mutex, 0 if it is unlocked.
+ */
+uintptr_t Mutex_getowner(const struct Mutex_t *o)
+{
+    return o->Owner;
+}
+
+/** Get the number of times the owner locked the mutex.
+ *
+ * Note: Meaningful only when called by the owner.
+ *
+ * @param o Pointer to mutex.
+ * @return Number of locks not yet unlocked, 0 if the mutex is unlocked.
+ */
+Size_t Mutex_getdepth(const struct Mutex_t *o)
+{
+    return o->Depth;
+}
+
+#if (MUTEX_PRIO_ENABLE != 0)
+
+/** Get the highest priority of the threads waiting for the mutex.
+ *
+ * For a scheduler to check which priority the owner inherited.
+ *
+ * @param o Pointer to mutex.
+ * @return Highest priority of the waiters, 0 if none is known.
+ */
+uint8_t Mutex_getwaitprio(const struct Mutex_t *o)
+{
+    return o->WaitPrio;
+}
+
+#endif /* MUTEX_PRIO_ENABLE */
+
+#if (MUTEX_STATS_ENABLE != 0)
+
+/** Get the statistics of the mutex.
+ *
+ * Note: The statistics are updated by the owner of the mutex without critical
+ * sections. The copy is consistent if it is taken while holding the mutex or
+ * while it is not used.
+ *
+ * @param o Pointer to mutex.
+ * @param stats Pointer to where the statistics are copied.
+ */
+void Mutex_getstats(const struct Mutex_t *o, struct MutexStats_t *stats)
+{
+    memcpy(stats, &o->Stats, sizeof(*stats));
+}
+
+/** Reset the statistics of the mutex.
+ *
+ * Note: Must be called while holding the mutex or while it is not used.
+ *
+ * @param o Pointer to mutex.
+ */
+void Mutex_resetstats(struct Mutex_t *o)
+{
+    memset(&o->Stats, 0, sizeof(o->Stats));
+}
+
+#endif /* MUTEX_STATS_ENABLE */
+
 #endif /* MUTEX_ENABLE */
@@ -30,13 +30,85 @@ extern "C" {
 
 #if (MUTEX_ENABLE != 0)
 
+/* The port may provide an identifier of the calling thread (never 0).
+ Otherwise all code, interrupt handlers included, runs as thread 1: a
+ recursive mutex must then not be shared with interrupt handlers. */
+#ifndef THREAD_ID
+    #define THREAD_ID() 1U
+#endif
+
+/* Priority inheritance. A scheduler that runs threads (or deferred interrupt
+ workers) with priorities defines the three macros below; priorities are
+ uint8_t and a larger value is a higher priority.
+
+ THREAD_PRIO()                  Priority of the calling thread.
+ MUTEX_PRIO_INHERIT(owner, prio) Run the thread owner at least at prio.
+ MUTEX_PRIO_RESTORE(owner)      Give owner back its own priority.
+
+ A thread waiting in Mutex_lock_wait() raises the owner to its priority every
+ time it wakes, so the new owner is raised after each unlock. The owner is
+ restored when it unlocks the mutex. Without MUTEX_PRIO_INHERIT nothing is
+ done and the lock and unlock cost nothing more. */
+#ifdef MUTEX_PRIO_INHERIT
+    #define MUTEX_PRIO_ENABLE 1
+#else
+    #define MUTEX_PRIO_ENABLE 0
+#endif
+
+#if (MUTEX_STATS_ENABLE != 0)
+
+/* The port may provide a nanosecond clock. Otherwise micros() is used. */
+#ifndef STATS_CLOCK_NS
+    #define STATS_CLOCK_NS() ((uint64_t)micros() * 1000U)
+#endif
+
+/* Histogram bin i counts the times t (ns) with 2^i <= t < 2^(i+1); bin 0 also
+ counts t = 0 and the last bin counts everything longer. */
+#define MUTEX_HIST_BINS 32U
+
+struct MutexStats_t {
+    uint32_t Locks;       /* Successful locks (not counting recursive ones). */
+    uint32_t Contended;   /* Locks that had to wait for another owner. */
+    uint64_t WaitNs;      /* Total time waited by the contended locks. */
+    uint64_t HoldNs;      /* Total time the mutex was held. */
+    uint64_t MaxWaitNs;
+    uint64_t MaxHoldNs;
+    uint32_t WaitHist[MUTEX_HIST_BINS]; /* Wait time of the contended locks. */
+    uint32_t HoldHist[MUTEX_HIST_BINS]; /* Hold time of every lock. */
+};
+
+#endif /* MUTEX_STATS_ENABLE */
+
 struct Mutex_t {
     struct Semaphore_t sem;
+    volatile uintptr_t Owner; /* THREAD_ID() of the owner, 0 if unlocked. */
+    Size_t Depth;             /* Locks taken by the owner. */
+    uint8_t Recursive;
+#if (MUTEX_PRIO_ENABLE != 0)
+    volatile uint8_t WaitPrio; /* Highest priority of the waiters. */
+#endif
+#if (MUTEX_STATS_ENABLE != 0)
+    uint64_t LockedNs;
+    struct MutexStats_t Stats;
+#endif
 };
 
 void Mutex_init(struct Mutex_t *o);
+void Mutex_initrecursive(struct Mutex_t *o);
 uint8_t Mutex_lock(struct Mutex_t *o);
+#if (WAIT_ENABLE != 0)
+    uint8_t Mutex_lock_wait(struct Mutex_t *o, uint32_t timeout_ms);
+#endif
 uint8_t Mutex_unlock(struct Mutex_t *o);
+uintptr_t Mutex_getowner(const struct Mutex_t *o);
+Size_t Mutex_getdepth(const struct Mutex_t *o);
+#if (MUTEX_PRIO_ENABLE != 0)
+    uint8_t Mutex_getwaitprio(const struct Mutex_t *o);
+#endif
+#if (MUTEX_STATS_ENABLE != 0)
+    void Mutex_getstats(const struct Mutex_t *o, struct MutexStats_t *stats);
+    void Mutex_resetstats(struct Mutex_t *o);
+#endif
 
 #endif /* MUTEX_ENABLE */
 
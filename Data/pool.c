@@ -0,0 +1,309 @@
+/*
+ Arduinutil Pool - Fixed-block memory pool implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/pool.h"
+#include <string.h>
+
+#if (POOL_ENABLE != 0)
+
+/* The first bytes of a free block point to the next free block. */
+#define NEXT(block) (*(void**)(block))
+
+/* Take up to num blocks from the list of the pool, linking them in a list.
+ Return the number of blocks taken. */
+static Size_t poolTake(struct Pool_t *o, void **list, Size_t num)
+{
+    Size_t taken = 0U;
+    void *first;
+    void *last = NULL;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        first = o->Free;
+        if(first != NULL)
+        {
+            last = first;
+            for(taken = 1U; taken < num && NEXT(last) != NULL; ++taken)
+                last = NEXT(last);
+            o->Free = NEXT(last);
+            NEXT(last) = NULL;
+
+            o->Stats.Used += taken;
+            if(o->Stats.Used > o->Stats.Peak)
+                o->Stats.Peak = o->Stats.Used;
+        }
+        else
+        {
+            ++o->Stats.Fails;
+        }
+    }
+    CRITICAL_EXIT();
+
+    *list = first;
+    return taken;
+}
+
+/* Give back to the pool a list of num blocks from first to last. */
+static void poolGive(struct Pool_t *o, void *first, void *last, Size_t num)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        NEXT(last) = o->Free;
+        o->Free = first;
+        o->Stats.Used -= num;
+    }
+    CRITICAL_EXIT();
+}
+
+#if (POOL_CACHE_ENABLE != 0)
+
+struct PoolCache_t {
+    struct Pool_t *Pool;
+    uint32_t Gen;
+    Size_t Num;
+    void *Blocks[POOL_CACHE_SIZE];
+};
+
+static __thread struct PoolCache_t PoolCaches[POOL_CACHE_POOLS];
+
+/* Generation of the last pool initialized. Never 0, which marks the caches
+ that are not used. */
+static uint32_t PoolGen;
+
+/* Cache of the pool for the calling thread, NULL if the pool is not cached or
+ all caches are used by other pools. A cache of the pool from before the last
+ Pool_init() is emptied without giving its blocks back. */
+static struct PoolCache_t *poolCache(struct Pool_t *o)
+{
+    struct PoolCache_t *unused = NULL;
+    uint8_t i;
+
+    if(o->CacheSize == 0U)
+        return NULL;
+
+    for(i = 0U; i < POOL_CACHE_POOLS; ++i)
+    {
+        if(PoolCaches[i].Pool == o)
+        {
+            if(PoolCaches[i].Gen == o->Gen)
+                return &PoolCaches[i];
+            PoolCaches[i].Pool = NULL;
+            PoolCaches[i].Num = 0U;
+        }
+        if(PoolCaches[i].Pool == NULL && unused == NULL)
+            unused = &PoolCaches[i];
+    }
+    if(unused != NULL)
+    {
+        unused->Pool = o;
+        unused->Gen = o->Gen;
+        unused->Num = 0U;
+    }
+    return unused;
+}
+
+/* Give back to the pool the blocks of the cache from position pos on. */
+static void poolCacheFlush(struct Pool_t *o, struct PoolCache_t *c, Size_t pos)
+{
+    Size_t i;
+
+    if(c->Num <= pos)
+        return;
+    for(i = pos; i + 1U < c->Num; ++i)
+        NEXT(c->Blocks[i]) = c->Blocks[i + 1U];
+    poolGive(o, c->Blocks[pos], c->Blocks[c->Num - 1U], c->Num - pos);
+    c->Num = pos;
+}
+
+#endif /* POOL_CACHE_ENABLE */
+
+/** Initialize pool struct with all blocks free.
+ *
+ * Note: Not thread-safe. With POOL_CACHE_ENABLE the blocks cached by threads
+ * for a previous use of the pool are discarded.
+ *
+ * @param o Pointer to pool.
+ * @param buff Pointer to the blocks (must be POOL_BUFSZ(length, size) bytes
+ * long and aligned for pointers).
+ * @param length Number of blocks.
+ * @param size Number of bytes per block.
+ */
+void Pool_init(struct Pool_t *o, void *buff, Size_t length, Size_t size)
+{
+    Size_t i;
+
+    ASSERT(length != 0U);
+
+    o->BlockSize = POOL_BLOCKSZ(size);
+    o->Length = length;
+    o->Buff = (uint8_t*)buff;
+    for(i = 0U; i + 1U < length; ++i)
+        NEXT(&o->Buff[i * o->BlockSize]) = &o->Buff[(i + 1U) * o->BlockSize];
+    NEXT(&o->Buff[i * o->BlockSize]) = NULL;
+    o->Free = o->Buff;
+    memset(&o->Stats, 0, sizeof(o->Stats));
+
+#if (POOL_CACHE_ENABLE != 0)
+    o->CacheSize = (length < POOL_CACHE_SIZE) ? 0U :
+            (length / 4U < POOL_CACHE_SIZE) ? length / 4U : POOL_CACHE_SIZE;
+    do {
+        o->Gen = __atomic_add_fetch(&PoolGen, 1U, __ATOMIC_RELAXED);
+    } while(o->Gen == 0U);
+#endif
+}
+
+/** Allocate a block.
+ *
+ * @param o Pointer to pool.
+ * @return Pointer to the block, NULL if there is no free block.
+ */
+void *Pool_alloc(struct Pool_t *o)
+{
+    void *block;
+#if (POOL_CACHE_ENABLE != 0)
+    struct PoolCache_t *c = poolCache(o);
+
+    if(c != NULL)
+    {
+        if(c->Num == 0U)
+        {
+            /* Refill half of the cache. */
+            Size_t num = poolTake(o, &block, o->CacheSize / 2U);
+            for(; num != 0U; --num)
+            {
+                c->Blocks[c->Num++] = block;
+                block = NEXT(block);
+            }
+            if(c->Num == 0U)
+                return NULL;
+        }
+        return c->Blocks[--c->Num];
+    }
+#endif
+
+    (void)poolTake(o, &block, 1U);
+    return block;
+}
+
+/** Free a block.
+ *
+ * @param o Pointer to pool.
+ * @param block Pointer to a block allocated from the pool.
+ */
+void Pool_free(struct Pool_t *o, void *block)
+{
+#if (POOL_CACHE_ENABLE != 0)
+    struct PoolCache_t *c;
+#endif
+
+    ASSERT((uint8_t*)block >= o->Buff &&
+            (uint8_t*)block < o->Buff + o->Length * o->BlockSize &&
+            ((uint8_t*)block - o->Buff) % o->BlockSize == 0U);
+
+#if (POOL_CACHE_ENABLE != 0)
+    c = poolCache(o);
+    if(c != NULL)
+    {
+        if(c->Num >= o->CacheSize)
+            poolCacheFlush(o, c, o->CacheSize / 2U);
+        c->Blocks[c->Num++] = block;
+        return;
+    }
+#endif
+
+    poolGive(o, block, block, 1U);
+}
+
+/** Get the number of blocks out of the pool.
+ *
+ * @param o Pointer to pool.
+ * @return Number of blocks allocated (or in thread caches).
+ */
+Size_t Pool_used(const struct Pool_t *o)
+{
+    Size_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Stats.Used;
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Get the statistics of the pool.
+ *
+ * @param o Pointer to pool.
+ * @param stats Pointer to where the statistics are copied.
+ */
+void Pool_getstats(const struct Pool_t *o, struct PoolStats_t *stats)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        memcpy(stats, &o->Stats, sizeof(*stats));
+    }
+    CRITICAL_EXIT();
+}
+
+/** Reset the peak and the failures of the pool statistics.
+ *
+ * @param o Pointer to pool.
+ */
+void Pool_resetstats(struct Pool_t *o)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        o->Stats.Peak = o->Stats.Used;
+        o->Stats.Fails = 0U;
+    }
+    CRITICAL_EXIT();
+}
+
+#if (POOL_CACHE_ENABLE != 0)
+
+/** Give back to the pool the free blocks cached by the calling thread.
+ *
+ * Note: Must be called by a thread that used the pool before it exits, or its
+ * cached blocks are lost.
+ *
+ * @param o Pointer to pool.
+ */
+void Pool_flushcache(struct Pool_t *o)
+{
+    struct PoolCache_t *c = poolCache(o);
+
+    if(c != NULL)
+    {
+        poolCacheFlush(o, c, 0U);
+        c->Pool = NULL;
+    }
+}
+
+#endif /* POOL_CACHE_ENABLE */
+
+#endif /* POOL_ENABLE */
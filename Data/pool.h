@@ -0,0 +1,95 @@
+/*
+ Arduinutil Pool - Fixed-block memory pool implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_POOL_H__
+#define __ARDUINUTIL_POOL_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (POOL_ENABLE != 0)
+
+/* Allocator of blocks of one size from a static buffer, for messages passed by
+ pointer (Mailbox_t, MultiMailbox_t, queues of pointers) where malloc() cannot
+ be used. The free blocks are kept in a list threaded through the blocks, so
+ allocating and freeing take constant time. Both can be called by interrupt
+ handlers.
+
+ With POOL_CACHE_ENABLE (GCC_Linux) each thread keeps up to CacheSize free
+ blocks of each of up to POOL_CACHE_POOLS pools. Most allocations and frees
+ then touch only the cache of the thread, which takes no lock; the list of the
+ pool is used to move blocks in batches. CacheSize is a quarter of the blocks,
+ at most POOL_CACHE_SIZE, so a thread that only frees blocks allocated by
+ another (a receiver of Mailbox_t messages) keeps few of them; pools smaller
+ than POOL_CACHE_SIZE blocks are not cached. Pool_init() gives the pool a new
+ Gen, and a cache of an older Gen is discarded, in any thread, the next time
+ it is used, since its blocks are back in the list. */
+struct PoolStats_t {
+    Size_t Used;   /* Blocks out of the pool (also the ones in thread caches). */
+    Size_t Peak;   /* Maximum of Used. */
+    uint32_t Fails; /* Allocations with no free block. */
+};
+
+struct Pool_t {
+    Size_t BlockSize;
+    Size_t Length;
+    void *Free;
+    uint8_t *Buff;
+    struct PoolStats_t Stats;
+#if (POOL_CACHE_ENABLE != 0)
+    Size_t CacheSize;
+    uint32_t Gen;
+#endif
+};
+
+/* Bytes used by a block of size bytes. Blocks hold a pointer while free. */
+#define POOL_BLOCKSZ(size) \
+    (((size) < sizeof(void*)) ? sizeof(void*) : \
+     ((size) + sizeof(void*) - 1U) / sizeof(void*) * sizeof(void*))
+
+/* Size of the buffer for length blocks of size bytes. */
+#define POOL_BUFSZ(length, size) ((length) * POOL_BLOCKSZ(size))
+
+#if (POOL_CACHE_ENABLE != 0)
+    #define POOL_CACHE_SIZE  16U
+    #define POOL_CACHE_POOLS 4U
+#endif
+
+void Pool_init(struct Pool_t *o, void *buff, Size_t length, Size_t size);
+void *Pool_alloc(struct Pool_t *o);
+void Pool_free(struct Pool_t *o, void *block);
+Size_t Pool_used(const struct Pool_t *o);
+void Pool_getstats(const struct Pool_t *o, struct PoolStats_t *stats);
+void Pool_resetstats(struct Pool_t *o);
+#if (POOL_CACHE_ENABLE != 0)
+    void Pool_flushcache(struct Pool_t *o);
+#endif
+
+#endif /* POOL_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_POOL_H__ */
@@ -0,0 +1,310 @@
+/*
+ Arduinutil PrioQueue - Priority queue (binary heap) implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Data/prioqueue.h"
+#include <string.h>
+
+#if (PRIOQUEUE_ENABLE != 0)
+
+/* The heap is changed in the critical section, which takes O(log n) swaps of
+ slot numbers. The items are copied in the critical section too, since their
+ slot is free again as soon as they leave the heap. */
+
+static uint8_t prioLess(const struct PrioQueue_t *o, Size_t a, Size_t b)
+{
+    return (int32_t)(o->Keys[o->Heap[a]] - o->Keys[o->Heap[b]]) < 0;
+}
+
+static void prioSwap(struct PrioQueue_t *o, Size_t a, Size_t b)
+{
+    Size_t slot = o->Heap[a];
+    o->Heap[a] = o->Heap[b];
+    o->Heap[b] = slot;
+    o->Pos[o->Heap[a]] = a;
+    o->Pos[o->Heap[b]] = b;
+}
+
+static Size_t prioSiftUp(struct PrioQueue_t *o, Size_t pos)
+{
+    while(pos != 0U)
+    {
+        Size_t parent = (pos - 1U) / 2U;
+        if(!prioLess(o, pos, parent))
+            break;
+        prioSwap(o, pos, parent);
+        pos = parent;
+    }
+    return pos;
+}
+
+static void prioSiftDown(struct PrioQueue_t *o, Size_t pos)
+{
+    for(;;)
+    {
+        Size_t child = 2U * pos + 1U;
+        if(child >= o->Used)
+            break;
+        if(child + 1U < o->Used && prioLess(o, child + 1U, child))
+            ++child;
+        if(!prioLess(o, child, pos))
+            break;
+        prioSwap(o, pos, child);
+        pos = child;
+    }
+}
+
+/* Remove the item at position pos of the heap. Its slot goes to Heap[Used]. */
+static void prioRemove(struct PrioQueue_t *o, Size_t pos)
+{
+    Size_t last = --(o->Used);
+    if(pos != last)
+    {
+        prioSwap(o, pos, last);
+        if(prioSiftUp(o, pos) == pos)
+            prioSiftDown(o, pos);
+    }
+}
+
+static uint8_t *prioItem(const struct PrioQueue_t *o, Size_t slot)
+{
+    return &o->Items[(size_t)slot * o->ItemSize];
+}
+
+/** Initialize priority queue struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to priority queue.
+ * @param buff Pointer to data buffer (must be PRIOQUEUE_BUFSZ(length,
+ * item_size) bytes long and aligned for uint32_t and Size_t).
+ * @param length Number of items the priority queue can hold.
+ * @param item_size Number of bytes per item.
+ */
+void PrioQueue_init(struct PrioQueue_t *o, void *buff, Size_t length, Size_t item_size)
+{
+    uint8_t *buff8 = (uint8_t*)buff;
+    Size_t i;
+
+    o->ItemSize = item_size;
+    o->Length = length;
+    o->Used = 0U;
+    o->Heap = (Size_t*)buff8;
+    o->Pos = &o->Heap[length];
+    o->Keys = (uint32_t*)&o->Pos[length];
+    o->Items = (uint8_t*)&o->Keys[length];
+
+    for(i = 0U; i < length; ++i)
+    {
+        o->Heap[i] = i;
+        o->Pos[i] = i;
+    }
+}
+
+/** Insert item in the priority queue.
+ *
+ * @param o Pointer to priority queue.
+ * @param key Key of the item (the smallest is removed first).
+ * @param val Pointer to item.
+ * @param handle Pointer to where the handle of the item is stored. May be
+ * NULL.
+ * @return 1U upon success, 0U otherwise.
+ */
+uint8_t PrioQueue_push(struct PrioQueue_t *o, uint32_t key, const void *val, Size_t *handle)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Used != o->Length;
+        if(ret != 0U)
+        {
+            Size_t pos = (o->Used)++;
+            Size_t slot = o->Heap[pos];
+
+            o->Keys[slot] = key;
+            memcpy(prioItem(o, slot), val, o->ItemSize);
+            prioSiftUp(o, pos);
+
+            if(handle != NULL)
+                *handle = slot;
+        }
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Remove the item with the smallest key.
+ *
+ * @param o Pointer to priority queue.
+ * @param key Pointer to where the key is stored. May be NULL.
+ * @param val Pointer to where the item is copied.
+ * @return 1U upon success, 0U if the priority queue is empty.
+ */
+uint8_t PrioQueue_pop(struct PrioQueue_t *o, uint32_t *key, void *val)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Used != 0U;
+        if(ret != 0U)
+        {
+            Size_t slot = o->Heap[0];
+
+            if(key != NULL)
+                *key = o->Keys[slot];
+            memcpy(val, prioItem(o, slot), o->ItemSize);
+            prioRemove(o, 0U);
+        }
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Get the item with the smallest key without removing it.
+ *
+ * @param o Pointer to priority queue.
+ * @param key Pointer to where the key is stored. May be NULL.
+ * @param val Pointer to where the item is copied. May be NULL.
+ * @return 1U upon success, 0U if the priority queue is empty.
+ */
+uint8_t PrioQueue_peek(struct PrioQueue_t *o, uint32_t *key, void *val)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Used != 0U;
+        if(ret != 0U)
+        {
+            Size_t slot = o->Heap[0];
+
+            if(key != NULL)
+                *key = o->Keys[slot];
+            if(val != NULL)
+                memcpy(val, prioItem(o, slot), o->ItemSize);
+        }
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Change the key of an item, e.g. to bring a deadline forward.
+ *
+ * @param o Pointer to priority queue.
+ * @param handle Handle of the item (see PrioQueue_push()).
+ * @param key New key of the item.
+ * @return 1U upon success, 0U if the item is not in the priority queue.
+ */
+uint8_t PrioQueue_setkey(struct PrioQueue_t *o, Size_t handle, uint32_t key)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = handle < o->Length && o->Pos[handle] < o->Used;
+        if(ret != 0U)
+        {
+            Size_t pos = o->Pos[handle];
+
+            o->Keys[handle] = key;
+            if(prioSiftUp(o, pos) == pos)
+                prioSiftDown(o, pos);
+        }
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Remove an item before it reaches the front.
+ *
+ * @param o Pointer to priority queue.
+ * @param handle Handle of the item (see PrioQueue_push()).
+ * @param val Pointer to where the item is copied. May be NULL.
+ * @return 1U upon success, 0U if the item is not in the priority queue.
+ */
+uint8_t PrioQueue_cancel(struct PrioQueue_t *o, Size_t handle, void *val)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = handle < o->Length && o->Pos[handle] < o->Used;
+        if(ret != 0U)
+        {
+            if(val != NULL)
+                memcpy(val, prioItem(o, handle), o->ItemSize);
+            prioRemove(o, o->Pos[handle]);
+        }
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Get the priority queue length.
+ *
+ * @param o Pointer to priority queue.
+ * @return Length of the priority queue.
+ */
+Size_t PrioQueue_length(const struct PrioQueue_t *o)
+{
+    return o->Length;
+}
+
+/** Get the number of items in the priority queue.
+ *
+ * @param o Pointer to priority queue.
+ * @return Number of items.
+ */
+Size_t PrioQueue_used(const struct PrioQueue_t *o)
+{
+    return o->Used;
+}
+
+/** Get the number of free positions in the priority queue.
+ *
+ * @param o Pointer to priority queue.
+ * @return Number of free positions.
+ */
+Size_t PrioQueue_free(const struct PrioQueue_t *o)
+{
+    return o->Length - o->Used;
+}
+
+/** Remove all items from the priority queue.
+ *
+ * @param o Pointer to priority queue.
+ */
+void PrioQueue_clear(struct PrioQueue_t *o)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        o->Used = 0U;
+    }
+    CRITICAL_EXIT();
+}
+
+#endif /* PRIOQUEUE_ENABLE */
@@ -0,0 +1,83 @@
+/*
+ Arduinutil PrioQueue - Priority queue (binary heap) implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_PRIOQUEUE_H__
+#define __ARDUINUTIL_PRIOQUEUE_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (PRIOQUEUE_ENABLE != 0)
+
+/* Items have a uint32_t key and the one with the smallest key is removed
+ first. Keys are compared as timer counts, (int32_t)(a - b) < 0, so deadlines
+ keep their order when the counter wraps; all the keys in the queue must be
+ less than 2^31 apart.
+
+ Each item is kept in a slot of the buffer, which does not move while the
+ item is in the queue, and the heap orders the slot numbers. The slot number
+ is returned by PrioQueue_push() as a handle to change the key or to cancel
+ the item. The handle is valid until the item is removed. Heap[Used] to
+ Heap[Length-1] hold the free slots.
+
+ The buffer holds Heap, Pos, Keys and then the items. Each array starts where
+ the previous one ends, so with a buffer aligned for Size_t and uint32_t every
+ array is aligned and the items are aligned for uint32_t. Items that need a
+ wider alignment (double, uint64_t on the host) must be copied in and out. */
+struct PrioQueue_t {
+    Size_t ItemSize;
+    Size_t Length;
+    volatile Size_t Used;
+    uint32_t *Keys;
+    Size_t *Heap;
+    Size_t *Pos;
+    uint8_t *Items;
+};
+
+/* Size of the buffer for length items of item_size bytes. */
+#define PRIOQUEUE_BUFSZ(length, item_size) \
+    ((length) * (sizeof(uint32_t) + 2U * sizeof(Size_t) + (item_size)))
+
+#define PRIOQUEUE_NOHANDLE ((Size_t)-1)
+
+void PrioQueue_init(struct PrioQueue_t *o, void *buff, Size_t length, Size_t item_size);
+uint8_t PrioQueue_push(struct PrioQueue_t *o, uint32_t key, const void *val, Size_t *handle);
+uint8_t PrioQueue_pop(struct PrioQueue_t *o, uint32_t *key, void *val);
+uint8_t PrioQueue_peek(struct PrioQueue_t *o, uint32_t *key, void *val);
+uint8_t PrioQueue_setkey(struct PrioQueue_t *o, Size_t handle, uint32_t key);
+uint8_t PrioQueue_cancel(struct PrioQueue_t *o, Size_t handle, void *val);
+Size_t PrioQueue_length(const struct PrioQueue_t *o);
+Size_t PrioQueue_used(const struct PrioQueue_t *o);
+Size_t PrioQueue_free(const struct PrioQueue_t *o);
+void PrioQueue_clear(struct PrioQueue_t *o);
+
+#define PrioQueue_empty(o) (PrioQueue_used(o) == 0U)
+#define PrioQueue_full(o)  (PrioQueue_free(o) == 0U)
+
+#endif /* PRIOQUEUE_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_PRIOQUEUE_H__ */
@@ -18,10 +18,40 @@
  */
 
 #include "Data/queue.h"
+#include "Data/wait.h"
 #include <string.h>
 
 #if (QUEUE_ENABLE != 0)
 
+/* Return the queue position size bytes after pos, wrapping around at the end
+ of the buffer. */
+static uint8_t *queueAdvance(const struct Queue_t *o, uint8_t *pos, size_t size)
+{
+    size_t left = (size_t)(o->BufEnd - pos) + o->ItemSize;
+    return (size < left) ? &pos[size] : &o->Buff[size - left];
+}
+
+/* Copy size bytes from src to the queue, starting at pos. At most two memcpy
+ are needed: up to the end of the buffer and from its start. */
+static void queueCopyIn(const struct Queue_t *o, uint8_t *pos, const uint8_t *src, size_t size)
+{
+    size_t first = (size_t)(o->BufEnd - pos) + o->ItemSize;
+    if(first > size)
+        first = size;
+    memcpy(pos, src, first);
+    memcpy(o->Buff, &src[first], size - first);
+}
+
+/* Copy size bytes from the queue to dst, starting at pos. */
+static void queueCopyOut(const struct Queue_t *o, const uint8_t *pos, uint8_t *dst, size_t size)
+{
+    size_t first = (size_t)(o->BufEnd - pos) + o->ItemSize;
+    if(first > size)
+        first = size;
+    memcpy(dst, pos, first);
+    memcpy(&dst[first], o->Buff, size - first);
+}
+
 /** Initialize queue struct.
  *
  * Note: Not thread-safe.
@@ -40,10 +70,12 @@ void Queue_init(struct Queue_t *o, void *buff, Size_t length, Size_t item_size)
     o->Used = 0U;
     o->WLock = 0U;
     o->RLock = 0U;
+    o->FLock = 0U;
     o->Head = buff8;
     o->Tail = buff8;
     o->Buff = buff8;
     o->BufEnd = &buff8[(length - 1U) * item_size];
+    QUEUESTATS_RESET(&o->Stats);
 }
 
 /** Insert item in the front of the queue.
@@ -66,7 +98,9 @@ uint8_t Queue_pushfront(struct Queue_t *o, const void *val)
             uint8_t *pos;
 
             lock = (o->WLock)++;
+            ++(o->FLock);
             --(o->Free);
+            QUEUESTATS_PUSHED(&o->Stats, o->Used + o->WLock + o->RLock, 1U);
 
             if((o->Head -= o->ItemSize) < o->Buff)
                 o->Head = o->BufEnd;
@@ -78,14 +112,23 @@ uint8_t Queue_pushfront(struct Queue_t *o, const void *val)
             }
             CRITICAL_ENTER();
 
+            --(o->FLock);
+
             if(lock == 0U)
             {
                 o->Used += o->WLock;
                 o->WLock = 0U;
             }
         }
+        else
+        {
+            QUEUESTATS_PUSH_FAILED(&o->Stats, 1U);
+        }
     }
     CRITICAL_EXIT();
+
+    if(ret != 0U)
+        WAKE_OBJECT(o);
     return ret;
 }
 
@@ -110,6 +153,7 @@ uint8_t Queue_pushback(struct Queue_t *o, const void *val)
 
             lock = (o->WLock)++;
             --(o->Free);
+            QUEUESTATS_PUSHED(&o->Stats, o->Used + o->WLock + o->RLock, 1U);
 
             pos = o->Tail;
             if((o->Tail += o->ItemSize) > o->BufEnd)
@@ -127,8 +171,96 @@ uint8_t Queue_pushback(struct Queue_t *o, const void *val)
                 o->WLock = 0U;
             }
         }
+        else
+        {
+            QUEUESTATS_PUSH_FAILED(&o->Stats, 1U);
+        }
     }
     CRITICAL_EXIT();
+
+    if(ret != 0U)
+        WAKE_OBJECT(o);
+    return ret;
+}
+
+/** Insert item in the back of the queue, removing the item in the front if
+ * the queue is full.
+ *
+ * The newest items are kept, which suits telemetry where stale data is worse
+ * than lost data. The time taken does not depend on the queue length.
+ *
+ * Note: Fails if the queue is full and a pop is copying an item out of it or
+ * Queue_pushfront() is copying an item into it, since the position of the
+ * item at the front can not be reused yet. Must not be used on a queue peeked
+ * with Queue_peek().
+ *
+ * @param o Pointer to queue.
+ * @param val Pointer to item.
+ * @param dropped Pointer to where the number of items removed (0U or 1U) is
+ * stored. May be NULL.
+ * @return 1U upon success, 0U otherwise.
+ */
+uint8_t Queue_pushback_overwrite(struct Queue_t *o, const void *val, Size_t *dropped)
+{
+    uint8_t ret;
+    Size_t drop = 0U;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = 1U;
+        if(o->Free != 0U)
+        {
+            --(o->Free);
+        }
+        else if(o->Used != 0U && o->RLock == 0U && o->FLock == 0U)
+        {
+            /* With no pop and no push to the front copying, the queue is full
+             only if Tail reached Head, so the item at Head is the oldest one
+             and its position is where the new one goes. */
+            --(o->Used);
+            if((o->Head += o->ItemSize) > o->BufEnd)
+                o->Head = o->Buff;
+            drop = 1U;
+            QUEUESTATS_OVERWRITTEN(&o->Stats, 1U);
+        }
+        else
+        {
+            ret = 0U;
+            QUEUESTATS_PUSH_FAILED(&o->Stats, 1U);
+        }
+
+        if(ret != 0U)
+        {
+            Size_t lock;
+            uint8_t *pos;
+
+            lock = (o->WLock)++;
+            QUEUESTATS_PUSHED(&o->Stats, o->Used + o->WLock + o->RLock, 1U);
+
+            pos = o->Tail;
+            if((o->Tail += o->ItemSize) > o->BufEnd)
+                o->Tail = o->Buff;
+
+            CRITICAL_EXIT();
+            {
+                memcpy(pos, val, o->ItemSize);
+            }
+            CRITICAL_ENTER();
+
+            if(lock == 0U)
+            {
+                o->Used += o->WLock;
+                o->WLock = 0U;
+            }
+        }
+    }
+    CRITICAL_EXIT();
+
+    if(dropped != NULL)
+        *dropped = drop;
+    if(ret != 0U)
+        WAKE_OBJECT(o);
     return ret;
 }
 
@@ -170,11 +302,43 @@ uint8_t Queue_popfront(struct Queue_t *o, void *val)
                 o->RLock = 0U;
             }
         }
+        else
+        {
+            QUEUESTATS_POP_FAILED(&o->Stats);
+        }
     }
     CRITICAL_EXIT();
     return ret;
 }
 
+#if (WAIT_ENABLE != 0)
+
+/** Remove item in the front of the queue, waiting for it if the queue is
+ * empty.
+ *
+ * Note: Must not be called with interrupts disabled.
+ *
+ * @param o Pointer to queue.
+ * @param val Pointer to item.
+ * @param timeout_ms Maximum time to wait in milliseconds (WAIT_FOREVER waits
+ * forever). See Wait_begin().
+ * @return 1U upon success, 0U if the timeout expired.
+ */
+uint8_t Queue_popfront_wait(struct Queue_t *o, void *val, uint32_t timeout_ms)
+{
+    struct Wait_t w;
+    uint8_t ret;
+
+    Wait_begin(&w, o, timeout_ms);
+    while((ret = Queue_popfront(o, val)) == 0U && Wait_sleep(&w) != 0U)
+    {
+    }
+    Wait_end(&w);
+    return ret;
+}
+
+#endif /* WAIT_ENABLE */
+
 /** Remove item in the back of the queue.
  *
  * @param o Pointer to queue.
@@ -207,6 +371,117 @@ uint8_t Queue_popback(struct Queue_t *o, void *val)
             }
             CRITICAL_ENTER();
 
+            if(lock == 0U)
+            {
+                o->Free += o->RLock;
+                o->RLock = 0U;
+            }
+        }
+        else
+        {
+            QUEUESTATS_POP_FAILED(&o->Stats);
+        }
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Insert up to num items in the back of the queue.
+ *
+ * The items are reserved with a single critical section and copied with at
+ * most two memcpy.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to the items.
+ * @param num Number of items.
+ * @return Number of items inserted (less than num if the queue gets full).
+ */
+Size_t Queue_pushback_n(struct Queue_t *o, const void *buff, Size_t num)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        if(num > o->Free)
+        {
+            QUEUESTATS_PUSH_FAILED(&o->Stats, num - o->Free);
+            num = o->Free;
+        }
+        if(num != 0U)
+        {
+            Size_t lock;
+            uint8_t *pos;
+            size_t size = (size_t)num * o->ItemSize;
+
+            lock = o->WLock;
+            o->WLock += num;
+            o->Free -= num;
+            QUEUESTATS_PUSHED(&o->Stats, o->Used + o->WLock + o->RLock, num);
+
+            pos = o->Tail;
+            o->Tail = queueAdvance(o, pos, size);
+
+            CRITICAL_EXIT();
+            {
+                queueCopyIn(o, pos, (const uint8_t*)buff, size);
+            }
+            CRITICAL_ENTER();
+
+            if(lock == 0U)
+            {
+                o->Used += o->WLock;
+                o->WLock = 0U;
+            }
+        }
+    }
+    CRITICAL_EXIT();
+
+    if(num != 0U)
+        WAKE_OBJECT(o);
+    return num;
+}
+
+/** Remove up to num items in the front of the queue.
+ *
+ * The items are reserved with a single critical section and copied with at
+ * most two memcpy.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to where the items are copied.
+ * @param num Number of items.
+ * @return Number of items removed (less than num if the queue gets empty).
+ */
+Size_t Queue_popfront_n(struct Queue_t *o, void *buff, Size_t num)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        if(num > o->Used)
+        {
+            if(o->Used == 0U)
+                QUEUESTATS_POP_FAILED(&o->Stats);
+            num = o->Used;
+        }
+        if(num != 0U)
+        {
+            Size_t lock;
+            uint8_t *pos;
+            size_t size = (size_t)num * o->ItemSize;
+
+            lock = o->RLock;
+            o->RLock += num;
+            o->Used -= num;
+
+            pos = o->Head;
+            o->Head = queueAdvance(o, pos, size);
+
+            CRITICAL_EXIT();
+            {
+                queueCopyOut(o, pos, (uint8_t*)buff, size);
+            }
+            CRITICAL_ENTER();
+
             if(lock == 0U)
             {
                 o->Free += o->RLock;
@@ -215,9 +490,120 @@ uint8_t Queue_popback(struct Queue_t *o, void *val)
         }
     }
     CRITICAL_EXIT();
+    return num;
+}
+
+/** Reserve num positions in the back of the queue to be written in place.
+ *
+ * The items are written directly in the queue buffer starting at *ptr. Only
+ * *contig of them are contiguous, the others continue at the start of the
+ * buffer. They are inserted in the queue by Queue_commit().
+ *
+ * Note: No other producer may insert items in the queue between
+ * Queue_reserve() and Queue_commit().
+ *
+ * @param o Pointer to queue.
+ * @param num Number of positions.
+ * @param ptr Pointer to where the address of the first position is stored.
+ * @param contig Pointer to where the number of contiguous positions is stored.
+ * @return 1U upon success, 0U if there are less than num free positions.
+ */
+uint8_t Queue_reserve(struct Queue_t *o, Size_t num, uint8_t **ptr, Size_t *contig)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Free >= num;
+        if(ret != 0U)
+        {
+            Size_t left = (Size_t)((o->BufEnd - o->Tail) / o->ItemSize) + 1U;
+            *ptr = o->Tail;
+            *contig = (num < left) ? num : left;
+        }
+    }
+    CRITICAL_EXIT();
     return ret;
 }
 
+/** Insert in the back of the queue num items written in place.
+ *
+ * @param o Pointer to queue.
+ * @param num Number of items (at most the number reserved).
+ */
+void Queue_commit(struct Queue_t *o, Size_t num)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ASSERT(num <= o->Free);
+
+        o->Free -= num;
+        o->Tail = queueAdvance(o, o->Tail, (size_t)num * o->ItemSize);
+        o->Used += num;
+        QUEUESTATS_PUSHED(&o->Stats, o->Used + o->WLock + o->RLock, num);
+    }
+    CRITICAL_EXIT();
+
+    WAKE_OBJECT(o);
+}
+
+/** Get num items in the front of the queue to be read in place.
+ *
+ * The items are read directly from the queue buffer starting at *ptr. Only
+ * *contig of them are contiguous, the others continue at the start of the
+ * buffer. They are removed from the queue by Queue_release().
+ *
+ * Note: No other consumer may remove items from the queue between
+ * Queue_peek() and Queue_release().
+ *
+ * @param o Pointer to queue.
+ * @param num Number of items.
+ * @param ptr Pointer to where the address of the first item is stored.
+ * @param contig Pointer to where the number of contiguous items is stored.
+ * @return 1U upon success, 0U if there are less than num items.
+ */
+uint8_t Queue_peek(struct Queue_t *o, Size_t num, uint8_t **ptr, Size_t *contig)
+{
+    uint8_t ret;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ret = o->Used >= num;
+        if(ret != 0U)
+        {
+            Size_t left = (Size_t)((o->BufEnd - o->Head) / o->ItemSize) + 1U;
+            *ptr = o->Head;
+            *contig = (num < left) ? num : left;
+        }
+    }
+    CRITICAL_EXIT();
+    return ret;
+}
+
+/** Remove from the front of the queue num items read in place.
+ *
+ * @param o Pointer to queue.
+ * @param num Number of items (at most the number peeked).
+ */
+void Queue_release(struct Queue_t *o, Size_t num)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        ASSERT(num <= o->Used);
+
+        o->Used -= num;
+        o->Head = queueAdvance(o, o->Head, (size_t)num * o->ItemSize);
+        o->Free += num;
+    }
+    CRITICAL_EXIT();
+}
+
 /** Get the queue length.
  *
  * @param o Pointer to queue.
@@ -286,10 +672,46 @@ void Queue_clear(struct Queue_t *o)
         o->Used = 0U;
         o->WLock = 0U;
         o->RLock = 0U;
+        o->FLock = 0U;
         o->Head = o->Buff;
         o->Tail = o->Buff;
     }
     CRITICAL_EXIT();
 }
 
+#if (QUEUE_STATS_ENABLE != 0)
+
+/** Get the queue statistics.
+ *
+ * @param o Pointer to queue.
+ * @param stats Pointer to where the statistics are copied.
+ */
+void Queue_getstats(const struct Queue_t *o, struct QueueStats_t *stats)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        *stats = o->Stats;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Clear the queue statistics.
+ *
+ * @param o Pointer to queue.
+ */
+void Queue_resetstats(struct Queue_t *o)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        QUEUESTATS_RESET(&o->Stats);
+    }
+    CRITICAL_EXIT();
+}
+
+#endif /* QUEUE_STATS_ENABLE */
+
 #endif /* QUEUE_ENABLE */
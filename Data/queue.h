@@ -27,6 +27,39 @@
 extern "C" {
 #endif
 
+/* Queue statistics, kept by Queue_t, SpscQueue_t and the typed queues when
+ QUEUE_STATS_ENABLE is set. */
+#if (QUEUE_STATS_ENABLE != 0)
+
+struct QueueStats_t {
+    Size_t MaxUsed;        /* Maximum number of used positions. */
+    uint32_t TotalItems;   /* Items inserted. */
+    uint32_t FailedPushes; /* Items that did not fit in the queue. */
+    uint32_t FailedPops;   /* Removals that found the queue empty. */
+    uint32_t Overwritten;  /* Items removed by Queue_pushback_overwrite(). */
+};
+
+#define QUEUESTATS_RESET(s) \
+    do{ (s)->MaxUsed = 0U; (s)->TotalItems = 0U; \
+        (s)->FailedPushes = 0U; (s)->FailedPops = 0U; \
+        (s)->Overwritten = 0U; }while(0U)
+#define QUEUESTATS_PUSHED(s, used, num) \
+    do{ if((used) > (s)->MaxUsed) (s)->MaxUsed = (used); \
+        (s)->TotalItems += (num); }while(0U)
+#define QUEUESTATS_PUSH_FAILED(s, num) do{ (s)->FailedPushes += (num); }while(0U)
+#define QUEUESTATS_POP_FAILED(s)       do{ ++(s)->FailedPops; }while(0U)
+#define QUEUESTATS_OVERWRITTEN(s, num) do{ (s)->Overwritten += (num); }while(0U)
+
+#else
+
+#define QUEUESTATS_RESET(s)             do{}while(0U)
+#define QUEUESTATS_PUSHED(s, used, num) do{}while(0U)
+#define QUEUESTATS_PUSH_FAILED(s, num)  do{}while(0U)
+#define QUEUESTATS_POP_FAILED(s)        do{}while(0U)
+#define QUEUESTATS_OVERWRITTEN(s, num)  do{}while(0U)
+
+#endif /* QUEUE_STATS_ENABLE */
+
 #if (QUEUE_ENABLE != 0)
 
 struct Queue_t {
@@ -35,24 +68,44 @@ struct Queue_t {
     volatile Size_t Used;
     volatile Size_t WLock;
     volatile Size_t RLock;
+    volatile Size_t FLock;
     uint8_t *volatile Head;
     uint8_t *volatile Tail;
     uint8_t* Buff;
     uint8_t* BufEnd;
+#if (QUEUE_STATS_ENABLE != 0)
+    struct QueueStats_t Stats;
+#endif
 };
 
 void Queue_init(struct Queue_t *o, void *buff, Size_t length, Size_t item_size);
 uint8_t Queue_pushfront(struct Queue_t *o, const void *val);
 uint8_t Queue_pushback(struct Queue_t *o, const void *val);
+uint8_t Queue_pushback_overwrite(struct Queue_t *o, const void *val, Size_t *dropped);
 uint8_t Queue_popfront(struct Queue_t *o, void *val);
 uint8_t Queue_popback(struct Queue_t *o, void *val);
+#if (WAIT_ENABLE != 0)
+    uint8_t Queue_popfront_wait(struct Queue_t *o, void *val, uint32_t timeout_ms);
+#endif
+Size_t Queue_pushback_n(struct Queue_t *o, const void *buff, Size_t num);
+Size_t Queue_popfront_n(struct Queue_t *o, void *buff, Size_t num);
+uint8_t Queue_reserve(struct Queue_t *o, Size_t num, uint8_t **ptr, Size_t *contig);
+void Queue_commit(struct Queue_t *o, Size_t num);
+uint8_t Queue_peek(struct Queue_t *o, Size_t num, uint8_t **ptr, Size_t *contig);
+void Queue_release(struct Queue_t *o, Size_t num);
 Size_t Queue_length(const struct Queue_t *o);
 Size_t Queue_used(const struct Queue_t *o);
 Size_t Queue_free(const struct Queue_t *o);
 void Queue_clear(struct Queue_t *o);
+#if (QUEUE_STATS_ENABLE != 0)
+    void Queue_getstats(const struct Queue_t *o, struct QueueStats_t *stats);
+    void Queue_resetstats(struct Queue_t *o);
+#endif
 
 #define Queue_write(o, val)    Queue_pushback(o, val)
 #define Queue_read(o, val)     Queue_popfront(o, val)
+#define Queue_write_n(o, buff, num) Queue_pushback_n(o, buff, num)
+#define Queue_read_n(o, buff, num)  Queue_popfront_n(o, buff, num)
 #define Queue_empty(o)         (Queue_used(o) == 0U)
 #define Queue_full(o)          (Queue_free(o) == 0U)
 
@@ -0,0 +1,256 @@
+/*
+ Arduinutil RecQueue - Variable-length record queue implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Data/recqueue.h"
+#include <string.h>
+
+#if (RECQUEUE_ENABLE != 0)
+
+/* The producer writes a record and its length before the release store of
+ Tail and the consumer reads it before the release store of Head, as in
+ SpscQueue_t. The lengths are copied with memcpy, since records are not
+ aligned. */
+#define LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
+#define HDRSZ ((Size_t)sizeof(Size_t))
+
+static Size_t recGetLength(const struct RecQueue_t *o, Size_t pos)
+{
+    Size_t length;
+    memcpy(&length, &o->Buff[pos], sizeof(length));
+    return length;
+}
+
+/* Position of the first record, following the jump to the start of the buffer
+ if there is one at head. The queue must not be empty. */
+static Size_t recFront(const struct RecQueue_t *o, Size_t head)
+{
+    if(o->Size - head < HDRSZ || recGetLength(o, head) == RECQUEUE_WRAP)
+        head = 0U;
+    return head;
+}
+
+/** Initialize queue struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to data buffer (must be size bytes long).
+ * @param size Number of bytes of the buffer. A record of length bytes takes
+ * RECQUEUE_RECSZ(length) bytes. Since records are contiguous, a record always
+ * fits in an empty queue only if RECQUEUE_RECSZ(length) is at most size/2.
+ */
+void RecQueue_init(struct RecQueue_t *o, void *buff, Size_t size)
+{
+    ASSERT(size > HDRSZ + 1U);
+
+    o->Size = size;
+    o->Head = 0U;
+    o->Tail = 0U;
+    o->Reserved = 0U;
+    o->Buff = (uint8_t*)buff;
+}
+
+/** Insert a record in the back of the queue.
+ *
+ * Note: Must be called only by the producer.
+ *
+ * @param o Pointer to queue.
+ * @param rec Pointer to the record.
+ * @param length Number of bytes of the record.
+ * @return 1U upon success, 0U if there is no contiguous space for the record.
+ */
+uint8_t RecQueue_push(struct RecQueue_t *o, const void *rec, Size_t length)
+{
+    uint8_t *ptr;
+
+    if(RecQueue_reserve(o, length, &ptr) == 0U)
+        return 0U;
+
+    memcpy(ptr, rec, length);
+    RecQueue_commit(o, length);
+    return 1U;
+}
+
+/** Remove the record in the front of the queue.
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to where the record is copied.
+ * @param size Number of bytes of buff.
+ * @param length Pointer to where the length of the record is stored.
+ * @return 1U upon success, 0U if the queue is empty or if the record is longer
+ * than size (it is left in the queue and *length is set).
+ */
+uint8_t RecQueue_pop(struct RecQueue_t *o, void *buff, Size_t size, Size_t *length)
+{
+    uint8_t *ptr;
+
+    if(RecQueue_peek(o, &ptr, length) == 0U || *length > size)
+        return 0U;
+
+    memcpy(buff, ptr, *length);
+    RecQueue_release(o);
+    return 1U;
+}
+
+/** Get contiguous space for a record of up to length bytes to be written in
+ * place.
+ *
+ * The record is written directly to the queue buffer starting at *ptr and
+ * inserted in the queue by RecQueue_commit().
+ *
+ * Note: Must be called only by the producer.
+ *
+ * @param o Pointer to queue.
+ * @param length Number of bytes of the record.
+ * @param ptr Pointer to where the address of the record is stored.
+ * @return 1U upon success, 0U if there is no contiguous space for the record.
+ */
+uint8_t RecQueue_reserve(struct RecQueue_t *o, Size_t length, uint8_t **ptr)
+{
+    Size_t tail = o->Tail;
+    Size_t head = LOAD_ACQUIRE(&o->Head);
+    Size_t need;
+    Size_t pos;
+
+    if(length >= o->Size - HDRSZ)
+        return 0U;
+    need = HDRSZ + length;
+
+    if(tail >= head)
+    {
+        /* Free space is at the end and at the start of the buffer. Tail must
+         not wrap to zero while Head is zero, or the queue would look empty. */
+        if(need <= o->Size - tail && (need != o->Size - tail || head != 0U))
+        {
+            pos = tail;
+        }
+        else if(need < head)
+        {
+            if(o->Size - tail >= HDRSZ)
+            {
+                Size_t wrap = RECQUEUE_WRAP;
+                memcpy(&o->Buff[tail], &wrap, sizeof(wrap));
+            }
+            pos = 0U;
+        }
+        else
+        {
+            return 0U;
+        }
+    }
+    else
+    {
+        if(need >= head - tail)
+            return 0U;
+        pos = tail;
+    }
+
+    o->Reserved = pos;
+    *ptr = &o->Buff[pos + HDRSZ];
+    return 1U;
+}
+
+/** Insert in the back of the queue a record written in place.
+ *
+ * Note: Must be called only by the producer.
+ *
+ * @param o Pointer to queue.
+ * @param length Number of bytes of the record (at most the length reserved).
+ */
+void RecQueue_commit(struct RecQueue_t *o, Size_t length)
+{
+    Size_t pos = o->Reserved;
+    Size_t tail;
+
+    memcpy(&o->Buff[pos], &length, sizeof(length));
+
+    tail = pos + HDRSZ + length;
+    if(tail == o->Size)
+        tail = 0U;
+    STORE_RELEASE(&o->Tail, tail);
+}
+
+/** Get the record in the front of the queue to be read in place.
+ *
+ * The record is read directly from the queue buffer starting at *ptr. It is
+ * removed from the queue by RecQueue_release().
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ * @param ptr Pointer to where the address of the record is stored.
+ * @param length Pointer to where the length of the record is stored.
+ * @return 1U upon success, 0U if the queue is empty.
+ */
+uint8_t RecQueue_peek(struct RecQueue_t *o, uint8_t **ptr, Size_t *length)
+{
+    Size_t head = o->Head;
+
+    if(head == LOAD_ACQUIRE(&o->Tail))
+        return 0U;
+
+    head = recFront(o, head);
+    *length = recGetLength(o, head);
+    *ptr = &o->Buff[head + HDRSZ];
+    return 1U;
+}
+
+/** Remove from the front of the queue the record read in place.
+ *
+ * Note: Must be called only by the consumer, after a successful
+ * RecQueue_peek().
+ *
+ * @param o Pointer to queue.
+ */
+void RecQueue_release(struct RecQueue_t *o)
+{
+    Size_t head = recFront(o, o->Head);
+
+    head += HDRSZ + recGetLength(o, head);
+    if(head == o->Size)
+        head = 0U;
+    STORE_RELEASE(&o->Head, head);
+}
+
+/** Check if the queue is empty.
+ *
+ * @param o Pointer to queue.
+ * @return 1U if the queue has no records, 0U otherwise.
+ */
+uint8_t RecQueue_empty(const struct RecQueue_t *o)
+{
+    return LOAD_ACQUIRE(&o->Head) == LOAD_ACQUIRE(&o->Tail);
+}
+
+/** Remove all records from the queue.
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ */
+void RecQueue_clear(struct RecQueue_t *o)
+{
+    STORE_RELEASE(&o->Head, LOAD_ACQUIRE(&o->Tail));
+}
+
+#endif /* RECQUEUE_ENABLE */
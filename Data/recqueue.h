@@ -0,0 +1,71 @@
+/*
+ Arduinutil RecQueue - Variable-length record queue implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_RECQUEUE_H__
+#define __ARDUINUTIL_RECQUEUE_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (RECQUEUE_ENABLE != 0)
+
+/* Each record is stored contiguously in the buffer as a Size_t length followed
+ by its bytes, so it can be read in place. A record that does not fit before
+ the end of the buffer is stored at its start; a length of RECQUEUE_WRAP (or
+ less than a length worth of bytes left) marks the jump. Head and Tail are
+ byte offsets; one byte is always left free to tell a full queue from an
+ empty one. As SpscQueue_t, the queue has no critical sections and is safe
+ with one producer and one consumer. */
+struct RecQueue_t {
+    Size_t Size;
+    volatile Size_t Head;
+    volatile Size_t Tail;
+    Size_t Reserved;
+    uint8_t *Buff;
+};
+
+#define RECQUEUE_WRAP ((Size_t)-1)
+
+/* Bytes used by a record of length bytes. */
+#define RECQUEUE_RECSZ(length) ((Size_t)(sizeof(Size_t) + (length)))
+
+void RecQueue_init(struct RecQueue_t *o, void *buff, Size_t size);
+uint8_t RecQueue_push(struct RecQueue_t *o, const void *rec, Size_t length);
+uint8_t RecQueue_pop(struct RecQueue_t *o, void *buff, Size_t size, Size_t *length);
+uint8_t RecQueue_reserve(struct RecQueue_t *o, Size_t length, uint8_t **ptr);
+void RecQueue_commit(struct RecQueue_t *o, Size_t length);
+uint8_t RecQueue_peek(struct RecQueue_t *o, uint8_t **ptr, Size_t *length);
+void RecQueue_release(struct RecQueue_t *o);
+uint8_t RecQueue_empty(const struct RecQueue_t *o);
+void RecQueue_clear(struct RecQueue_t *o);
+
+#define RecQueue_write(o, rec, length)       RecQueue_push(o, rec, length)
+#define RecQueue_read(o, buff, size, length) RecQueue_pop(o, buff, size, length)
+
+#endif /* RECQUEUE_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_RECQUEUE_H__ */
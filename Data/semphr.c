@@ -18,10 +18,22 @@
  */
 
 #include "Data/semphr.h"
+#include "Data/wait.h"
 #include <string.h>
 
 #if (SEMAPHORE_ENABLE != 0)
 
+#if (SEMAPHORE_CAS_ENABLE != 0)
+/* Count is changed with compare-and-swap instead of a critical section, so
+ threads locking different semaphores (or the same one) do not serialize on
+ the interrupt lock. Semaphore_lock_wait() spins a little before parking the
+ thread with Wait_sleep(), since a mutex is usually held for a short time. */
+#define SEMAPHORE_SPIN 100U
+#define LOAD_RELAXED(ptr) __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define CAS(ptr, expected, desired, order) \
+    __atomic_compare_exchange_n(ptr, expected, desired, 1, order, __ATOMIC_RELAXED)
+#endif
+
 /** Initialize semaphore struct as a binary semaphore.
  *
  * Note: Not thread-safe.
@@ -53,6 +65,15 @@ void Semaphore_init(struct Semaphore_t *o, Size_t max)
  */
 uint8_t Semaphore_lock(struct Semaphore_t *o)
 {
+#if (SEMAPHORE_CAS_ENABLE != 0)
+    Size_t count = LOAD_RELAXED(&o->Count);
+
+    do {
+        if(count == 0U)
+            return 0U;
+    } while(!CAS(&o->Count, &count, count - 1U, __ATOMIC_ACQUIRE));
+    return 1U;
+#else
     uint8_t ret;
     CRITICAL_VAL();
 
@@ -66,8 +87,44 @@ uint8_t Semaphore_lock(struct Semaphore_t *o)
     }
     CRITICAL_EXIT();
     return ret;
+#endif
+}
+
+#if (WAIT_ENABLE != 0)
+
+/** Lock semaphore, waiting for it to be unlocked if needed.
+ *
+ * Note: Must not be called with interrupts disabled.
+ *
+ * @param o Pointer to semaphore.
+ * @param timeout_ms Maximum time to wait in milliseconds (WAIT_FOREVER waits
+ * forever). See Wait_begin().
+ * @return 1U upon success, 0U if the timeout expired.
+ */
+uint8_t Semaphore_lock_wait(struct Semaphore_t *o, uint32_t timeout_ms)
+{
+    struct Wait_t w;
+    uint8_t ret;
+
+#if (SEMAPHORE_CAS_ENABLE != 0)
+    uint8_t spin;
+    for(spin = 0U; spin < SEMAPHORE_SPIN; ++spin)
+    {
+        if(Semaphore_lock(o) != 0U)
+            return 1U;
+    }
+#endif
+
+    Wait_begin(&w, o, timeout_ms);
+    while((ret = Semaphore_lock(o)) == 0U && Wait_sleep(&w) != 0U)
+    {
+    }
+    Wait_end(&w);
+    return ret;
 }
 
+#endif /* WAIT_ENABLE */
+
 /** Unlock semaphore.
  *
  * @param o Pointer to semaphore.
@@ -76,6 +133,13 @@ uint8_t Semaphore_lock(struct Semaphore_t *o)
 uint8_t Semaphore_unlock(struct Semaphore_t *o)
 {
     uint8_t ret;
+#if (SEMAPHORE_CAS_ENABLE != 0)
+    Size_t count = LOAD_RELAXED(&o->Count);
+
+    do {
+        ret = count < o->Max;
+    } while(ret != 0U && !CAS(&o->Count, &count, count + 1U, __ATOMIC_RELEASE));
+#else
     CRITICAL_VAL();
 
     CRITICAL_ENTER();
@@ -87,6 +151,10 @@ uint8_t Semaphore_unlock(struct Semaphore_t *o)
         }
     }
     CRITICAL_EXIT();
+#endif
+
+    if(ret != 0U)
+        WAKE_OBJECT(o);
     return ret;
 }
 
@@ -97,6 +165,9 @@ uint8_t Semaphore_unlock(struct Semaphore_t *o)
  */
 Size_t Semaphore_getcount(const struct Semaphore_t *o)
 {
+#if (SEMAPHORE_CAS_ENABLE != 0)
+    return LOAD_RELAXED(&o->Count);
+#else
     Size_t ret;
     CRITICAL_VAL();
 
@@ -106,6 +177,7 @@ Size_t Semaphore_getcount(const struct Semaphore_t *o)
     }
     CRITICAL_EXIT();
     return ret;
+#endif
 }
 
 /** Get semaphore maximum count value.
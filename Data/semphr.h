@@ -37,6 +37,9 @@ struct Semaphore_t {
 void Semaphore_initbinary(struct Semaphore_t *o);
 void Semaphore_init(struct Semaphore_t *o, Size_t max);
 uint8_t Semaphore_lock(struct Semaphore_t *o);
+#if (WAIT_ENABLE != 0)
+    uint8_t Semaphore_lock_wait(struct Semaphore_t *o, uint32_t timeout_ms);
+#endif
 uint8_t Semaphore_unlock(struct Semaphore_t *o);
 Size_t Semaphore_getcount(const struct Semaphore_t *o);
 Size_t Semaphore_getmax(const struct Semaphore_t *o);
@@ -0,0 +1,71 @@
+/*
+ Arduinutil SeqLock - Sequence lock implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/seqlock.h"
+#include <string.h>
+
+#if (SEQLOCK_ENABLE != 0)
+
+/** Initialize seqlock struct.
+ *
+ * Note: Not thread-safe. A static seqlock can be initialized with
+ * SEQLOCK_INIT.
+ *
+ * @param o Pointer to seqlock.
+ */
+void SeqLock_init(struct SeqLock_t *o)
+{
+    o->Seq = 0U;
+}
+
+/** Copy data to a variable protected by the seqlock.
+ *
+ * Note: Must be called only by the writer.
+ *
+ * @param o Pointer to seqlock.
+ * @param dst Pointer to the protected variable.
+ * @param src Pointer to the new data.
+ * @param size Number of bytes to copy.
+ */
+void SeqLock_write(struct SeqLock_t *o, void *dst, const void *src, Size_t size)
+{
+    SeqLock_writebegin(o);
+    memcpy(dst, src, size);
+    SeqLock_writeend(o);
+}
+
+/** Copy a consistent snapshot of a variable protected by the seqlock.
+ *
+ * @param o Pointer to seqlock.
+ * @param dst Pointer to where the data is copied.
+ * @param src Pointer to the protected variable.
+ * @param size Number of bytes to copy.
+ */
+void SeqLock_read(const struct SeqLock_t *o, void *dst, const void *src, Size_t size)
+{
+    Size_t seq;
+
+    do {
+        seq = SeqLock_readbegin(o);
+        memcpy(dst, src, size);
+    } while(SeqLock_readretry(o, seq) != 0U);
+}
+
+#endif /* SEQLOCK_ENABLE */
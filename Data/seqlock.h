@@ -0,0 +1,114 @@
+/*
+ Arduinutil SeqLock - Sequence lock implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_SEQLOCK_H__
+#define __ARDUINUTIL_SEQLOCK_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (SEQLOCK_ENABLE != 0)
+
+/* One writer publishes data that takes several words (or a word wider than the
+ processor) and the readers take consistent snapshots of it without disabling
+ interrupts. The writer makes Seq odd, changes the data and makes Seq even
+ again. A reader copies the data between two reads of Seq and retries if Seq
+ was odd or changed:
+
+  do {
+      seq = SeqLock_readbegin(&lock);
+      copy = data;
+  } while(SeqLock_readretry(&lock, seq));
+
+ The writer never waits. Several writers must be serialized, for example with a
+ critical section. A reader must not interrupt the writer (a main loop reading
+ data written by an interrupt handler is fine, the opposite is not), or it
+ would wait for it forever. Seq is a Size_t, so it is read in one access. */
+struct SeqLock_t {
+    volatile Size_t Seq;
+};
+
+#define SEQLOCK_INIT { 0U }
+
+void SeqLock_init(struct SeqLock_t *o);
+void SeqLock_write(struct SeqLock_t *o, void *dst, const void *src, Size_t size);
+void SeqLock_read(const struct SeqLock_t *o, void *dst, const void *src, Size_t size);
+
+/** Start changing the data.
+ *
+ * Note: Must be called only by the writer.
+ *
+ * @param o Pointer to seqlock.
+ */
+static __inline void SeqLock_writebegin(struct SeqLock_t *o)
+{
+    __atomic_store_n(&o->Seq, (Size_t)(o->Seq + 1U), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/** Finish changing the data.
+ *
+ * Note: Must be called only by the writer.
+ *
+ * @param o Pointer to seqlock.
+ */
+static __inline void SeqLock_writeend(struct SeqLock_t *o)
+{
+    __atomic_store_n(&o->Seq, (Size_t)(o->Seq + 1U), __ATOMIC_RELEASE);
+}
+
+/** Start reading the data, waiting while the writer changes it.
+ *
+ * @param o Pointer to seqlock.
+ * @return Sequence to be passed to SeqLock_readretry().
+ */
+static __inline Size_t SeqLock_readbegin(const struct SeqLock_t *o)
+{
+    Size_t seq;
+    while(((seq = __atomic_load_n(&o->Seq, __ATOMIC_ACQUIRE)) & 1U) != 0U)
+    {
+    }
+    return seq;
+}
+
+/** Finish reading the data.
+ *
+ * @param o Pointer to seqlock.
+ * @param seq Value returned by SeqLock_readbegin().
+ * @return 1U if the data changed while it was read and must be read again, 0U
+ * if the copy is consistent.
+ */
+static __inline uint8_t SeqLock_readretry(const struct SeqLock_t *o, Size_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&o->Seq, __ATOMIC_RELAXED) != seq;
+}
+
+#endif /* SEQLOCK_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_SEQLOCK_H__ */
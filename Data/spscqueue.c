@@ -0,0 +1,384 @@
+/*
+ Arduinutil SpscQueue - Single-producer single-consumer queue implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Data/spscqueue.h"
+#include <string.h>
+
+#if (SPSCQUEUE_ENABLE != 0)
+
+/* The queue has no critical sections. It is safe as long as only one context
+ (the main loop or one interrupt) pushes and only one context pops. The
+ producer publishes an item with a release store of Tail after copying it and
+ the consumer frees a slot with a release store of Head after copying it out;
+ each side reads the index of the other with an acquire load. Size_t must be
+ read and written with a single instruction, which is true for all the ports. */
+#define LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
+static Size_t spscUsed(const struct SpscQueue_t *o, Size_t head, Size_t tail)
+{
+    return (tail >= head) ? (Size_t)(tail - head) : (Size_t)(tail + 2U * o->Length - head);
+}
+
+static Size_t spscNext(const struct SpscQueue_t *o, Size_t pos)
+{
+    return (++pos < 2U * o->Length) ? pos : 0U;
+}
+
+static Size_t spscAdvance(const struct SpscQueue_t *o, Size_t pos, Size_t num)
+{
+    Size_t left = 2U * o->Length - pos;
+    return (num < left) ? (pos + num) : (num - left);
+}
+
+static uint8_t *spscItem(const struct SpscQueue_t *o, Size_t pos)
+{
+    if(pos >= o->Length)
+        pos -= o->Length;
+    return &o->Buff[pos * o->ItemSize];
+}
+
+/* Copy num items from src to the queue, starting at pos. At most two memcpy
+ are needed: up to the end of the buffer and from its start. */
+static void spscCopyIn(const struct SpscQueue_t *o, Size_t pos, const uint8_t *src, Size_t num)
+{
+    Size_t first;
+    if(pos >= o->Length)
+        pos -= o->Length;
+    first = o->Length - pos;
+    if(first > num)
+        first = num;
+    memcpy(&o->Buff[pos * o->ItemSize], src, (size_t)first * o->ItemSize);
+    memcpy(o->Buff, &src[(size_t)first * o->ItemSize], (size_t)(num - first) * o->ItemSize);
+}
+
+/* Copy num items from the queue to dst, starting at pos. */
+static void spscCopyOut(const struct SpscQueue_t *o, Size_t pos, uint8_t *dst, Size_t num)
+{
+    Size_t first;
+    if(pos >= o->Length)
+        pos -= o->Length;
+    first = o->Length - pos;
+    if(first > num)
+        first = num;
+    memcpy(dst, &o->Buff[pos * o->ItemSize], (size_t)first * o->ItemSize);
+    memcpy(&dst[(size_t)first * o->ItemSize], o->Buff, (size_t)(num - first) * o->ItemSize);
+}
+
+/** Initialize queue struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to data buffer (must be length*item_size bytes long).
+ * @param length Number of items the queue can hold (at most half the maximum
+ * value of Size_t).
+ * @param item_size Number of bytes per item.
+ */
+void SpscQueue_init(struct SpscQueue_t *o, void *buff, Size_t length, Size_t item_size)
+{
+    ASSERT(length != 0U && length <= ((Size_t)-1) / 2U);
+
+    o->ItemSize = item_size;
+    o->Length = length;
+    o->Head = 0U;
+    o->Tail = 0U;
+    o->Buff = (uint8_t*)buff;
+    QUEUESTATS_RESET(&o->Stats);
+}
+
+/** Insert item in the back of the queue.
+ *
+ * Note: Must be called only by the producer.
+ *
+ * @param o Pointer to queue.
+ * @param val Pointer to item.
+ * @return 1U upon success, 0U otherwise.
+ */
+uint8_t SpscQueue_pushback(struct SpscQueue_t *o, const void *val)
+{
+    Size_t tail = o->Tail;
+    Size_t head = LOAD_ACQUIRE(&o->Head);
+
+    Size_t used = spscUsed(o, head, tail);
+
+    if(used == o->Length)
+    {
+        QUEUESTATS_PUSH_FAILED(&o->Stats, 1U);
+        return 0U;
+    }
+
+    memcpy(spscItem(o, tail), val, o->ItemSize);
+    STORE_RELEASE(&o->Tail, spscNext(o, tail));
+    QUEUESTATS_PUSHED(&o->Stats, used + 1U, 1U);
+    return 1U;
+}
+
+/** Remove item in the front of the queue.
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ * @param val Pointer to item.
+ * @return 1U upon success, 0U otherwise.
+ */
+uint8_t SpscQueue_popfront(struct SpscQueue_t *o, void *val)
+{
+    Size_t head = o->Head;
+    Size_t tail = LOAD_ACQUIRE(&o->Tail);
+
+    if(head == tail)
+    {
+        QUEUESTATS_POP_FAILED(&o->Stats);
+        return 0U;
+    }
+
+    memcpy(val, spscItem(o, head), o->ItemSize);
+    STORE_RELEASE(&o->Head, spscNext(o, head));
+    return 1U;
+}
+
+/** Insert up to num items in the back of the queue.
+ *
+ * Note: Must be called only by the producer.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to the items.
+ * @param num Number of items.
+ * @return Number of items inserted (less than num if the queue gets full).
+ */
+Size_t SpscQueue_pushback_n(struct SpscQueue_t *o, const void *buff, Size_t num)
+{
+    Size_t tail = o->Tail;
+    Size_t head = LOAD_ACQUIRE(&o->Head);
+    Size_t used = spscUsed(o, head, tail);
+    Size_t free = o->Length - used;
+
+    if(num > free)
+    {
+        QUEUESTATS_PUSH_FAILED(&o->Stats, num - free);
+        num = free;
+    }
+    if(num != 0U)
+    {
+        spscCopyIn(o, tail, (const uint8_t*)buff, num);
+        STORE_RELEASE(&o->Tail, spscAdvance(o, tail, num));
+        QUEUESTATS_PUSHED(&o->Stats, used + num, num);
+    }
+    return num;
+}
+
+/** Remove up to num items in the front of the queue.
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ * @param buff Pointer to where the items are copied.
+ * @param num Number of items.
+ * @return Number of items removed (less than num if the queue gets empty).
+ */
+Size_t SpscQueue_popfront_n(struct SpscQueue_t *o, void *buff, Size_t num)
+{
+    Size_t head = o->Head;
+    Size_t tail = LOAD_ACQUIRE(&o->Tail);
+    Size_t used = spscUsed(o, head, tail);
+
+    if(num > used)
+    {
+        if(used == 0U)
+            QUEUESTATS_POP_FAILED(&o->Stats);
+        num = used;
+    }
+    if(num != 0U)
+    {
+        spscCopyOut(o, head, (uint8_t*)buff, num);
+        STORE_RELEASE(&o->Head, spscAdvance(o, head, num));
+    }
+    return num;
+}
+
+/** Reserve num positions in the back of the queue to be written in place.
+ *
+ * The items are written directly in the queue buffer starting at *ptr. Only
+ * *contig of them are contiguous, the others continue at the start of the
+ * buffer. They are inserted in the queue by SpscQueue_commit().
+ *
+ * Note: Must be called only by the producer.
+ *
+ * @param o Pointer to queue.
+ * @param num Number of positions.
+ * @param ptr Pointer to where the address of the first position is stored.
+ * @param contig Pointer to where the number of contiguous positions is stored.
+ * @return 1U upon success, 0U if there are less than num free positions.
+ */
+uint8_t SpscQueue_reserve(struct SpscQueue_t *o, Size_t num, uint8_t **ptr, Size_t *contig)
+{
+    Size_t tail = o->Tail;
+    Size_t head = LOAD_ACQUIRE(&o->Head);
+    Size_t left;
+
+    if(o->Length - spscUsed(o, head, tail) < num)
+        return 0U;
+
+    left = o->Length - ((tail >= o->Length) ? (tail - o->Length) : tail);
+    *ptr = spscItem(o, tail);
+    *contig = (num < left) ? num : left;
+    return 1U;
+}
+
+/** Insert in the back of the queue num items written in place.
+ *
+ * Note: Must be called only by the producer.
+ *
+ * @param o Pointer to queue.
+ * @param num Number of items (at most the number reserved).
+ */
+void SpscQueue_commit(struct SpscQueue_t *o, Size_t num)
+{
+    Size_t tail = o->Tail;
+    Size_t used = spscUsed(o, LOAD_ACQUIRE(&o->Head), tail);
+
+    ASSERT(num <= o->Length - used);
+
+    STORE_RELEASE(&o->Tail, spscAdvance(o, tail, num));
+    QUEUESTATS_PUSHED(&o->Stats, used + num, num);
+}
+
+/** Get num items in the front of the queue to be read in place.
+ *
+ * The items are read directly from the queue buffer starting at *ptr. Only
+ * *contig of them are contiguous, the others continue at the start of the
+ * buffer. They are removed from the queue by SpscQueue_release().
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ * @param num Number of items.
+ * @param ptr Pointer to where the address of the first item is stored.
+ * @param contig Pointer to where the number of contiguous items is stored.
+ * @return 1U upon success, 0U if there are less than num items.
+ */
+uint8_t SpscQueue_peek(struct SpscQueue_t *o, Size_t num, uint8_t **ptr, Size_t *contig)
+{
+    Size_t head = o->Head;
+    Size_t tail = LOAD_ACQUIRE(&o->Tail);
+    Size_t left;
+
+    if(spscUsed(o, head, tail) < num)
+        return 0U;
+
+    left = o->Length - ((head >= o->Length) ? (head - o->Length) : head);
+    *ptr = spscItem(o, head);
+    *contig = (num < left) ? num : left;
+    return 1U;
+}
+
+/** Remove from the front of the queue num items read in place.
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ * @param num Number of items (at most the number peeked).
+ */
+void SpscQueue_release(struct SpscQueue_t *o, Size_t num)
+{
+    Size_t head = o->Head;
+
+    ASSERT(num <= spscUsed(o, head, LOAD_ACQUIRE(&o->Tail)));
+
+    STORE_RELEASE(&o->Head, spscAdvance(o, head, num));
+}
+
+/** Get the queue length.
+ *
+ * @param o Pointer to queue.
+ * @return Length of the queue.
+ */
+Size_t SpscQueue_length(const struct SpscQueue_t *o)
+{
+    return o->Length;
+}
+
+/** Get the number of used positions of the queue.
+ *
+ * Note: The value may be outdated if the other side is running.
+ *
+ * @param o Pointer to queue.
+ * @return Number of used positions of the queue.
+ */
+Size_t SpscQueue_used(const struct SpscQueue_t *o)
+{
+    Size_t head = LOAD_ACQUIRE(&o->Head);
+    Size_t tail = LOAD_ACQUIRE(&o->Tail);
+    return spscUsed(o, head, tail);
+}
+
+/** Get the number of free positions of the queue.
+ *
+ * Note: The value may be outdated if the other side is running.
+ *
+ * @param o Pointer to queue.
+ * @return Number of free positions of the queue.
+ */
+Size_t SpscQueue_free(const struct SpscQueue_t *o)
+{
+    return o->Length - SpscQueue_used(o);
+}
+
+/** Clear the queue, freeing all positions.
+ *
+ * Note: Must be called only by the consumer.
+ *
+ * @param o Pointer to queue.
+ */
+void SpscQueue_clear(struct SpscQueue_t *o)
+{
+    STORE_RELEASE(&o->Head, LOAD_ACQUIRE(&o->Tail));
+}
+
+#if (QUEUE_STATS_ENABLE != 0)
+
+/** Get the queue statistics.
+ *
+ * Note: The producer updates MaxUsed, TotalItems and FailedPushes and the
+ * consumer updates FailedPops, without locking. The values copied are exact
+ * only if neither side is running.
+ *
+ * @param o Pointer to queue.
+ * @param stats Pointer to where the statistics are copied.
+ */
+void SpscQueue_getstats(const struct SpscQueue_t *o, struct QueueStats_t *stats)
+{
+    *stats = o->Stats;
+}
+
+/** Clear the queue statistics.
+ *
+ * Note: Must not be called while the producer or the consumer is running.
+ *
+ * @param o Pointer to queue.
+ */
+void SpscQueue_resetstats(struct SpscQueue_t *o)
+{
+    QUEUESTATS_RESET(&o->Stats);
+}
+
+#endif /* QUEUE_STATS_ENABLE */
+
+#endif /* SPSCQUEUE_ENABLE */
@@ -0,0 +1,79 @@
+/*
+ Arduinutil SpscQueue - Single-producer single-consumer queue implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_SPSCQUEUE_H__
+#define __ARDUINUTIL_SPSCQUEUE_H__
+
+#include "Arduinutil.h"
+#include "Data/queue.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (SPSCQUEUE_ENABLE != 0)
+
+/* Head and Tail count from 0 to 2*Length-1, so that a full queue (Tail-Head
+ equal to Length) is different from an empty one (Tail equal to Head) without
+ wasting a slot. Head is written only by the consumer and Tail only by the
+ producer. */
+struct SpscQueue_t {
+    Size_t ItemSize;
+    Size_t Length;
+    volatile Size_t Head;
+    volatile Size_t Tail;
+    uint8_t *Buff;
+#if (QUEUE_STATS_ENABLE != 0)
+    struct QueueStats_t Stats;
+#endif
+};
+
+void SpscQueue_init(struct SpscQueue_t *o, void *buff, Size_t length, Size_t item_size);
+uint8_t SpscQueue_pushback(struct SpscQueue_t *o, const void *val);
+uint8_t SpscQueue_popfront(struct SpscQueue_t *o, void *val);
+Size_t SpscQueue_pushback_n(struct SpscQueue_t *o, const void *buff, Size_t num);
+Size_t SpscQueue_popfront_n(struct SpscQueue_t *o, void *buff, Size_t num);
+uint8_t SpscQueue_reserve(struct SpscQueue_t *o, Size_t num, uint8_t **ptr, Size_t *contig);
+void SpscQueue_commit(struct SpscQueue_t *o, Size_t num);
+uint8_t SpscQueue_peek(struct SpscQueue_t *o, Size_t num, uint8_t **ptr, Size_t *contig);
+void SpscQueue_release(struct SpscQueue_t *o, Size_t num);
+Size_t SpscQueue_length(const struct SpscQueue_t *o);
+Size_t SpscQueue_used(const struct SpscQueue_t *o);
+Size_t SpscQueue_free(const struct SpscQueue_t *o);
+void SpscQueue_clear(struct SpscQueue_t *o);
+#if (QUEUE_STATS_ENABLE != 0)
+    void SpscQueue_getstats(const struct SpscQueue_t *o, struct QueueStats_t *stats);
+    void SpscQueue_resetstats(struct SpscQueue_t *o);
+#endif
+
+#define SpscQueue_write(o, val)    SpscQueue_pushback(o, val)
+#define SpscQueue_read(o, val)     SpscQueue_popfront(o, val)
+#define SpscQueue_write_n(o, buff, num) SpscQueue_pushback_n(o, buff, num)
+#define SpscQueue_read_n(o, buff, num)  SpscQueue_popfront_n(o, buff, num)
+#define SpscQueue_empty(o)         (SpscQueue_used(o) == 0U)
+#define SpscQueue_full(o)          (SpscQueue_free(o) == 0U)
+
+#endif /* SPSCQUEUE_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_SPSCQUEUE_H__ */
@@ -0,0 +1,149 @@
+/*
+ Arduinutil TripleBuffer - Triple buffer implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/triplebuffer.h"
+#include "Data/wait.h"
+#include <string.h>
+
+#if (TRIPLEBUFFER_ENABLE != 0)
+
+#if (TRIPLEBUFFER_CAS_ENABLE != 0)
+/* The exchange of State is acquire/release, so the frame written before it is
+ published is visible to the reader that takes it. Only the writer sets
+ TRIPLEBUFFER_NEW, so the reader can test it first with a relaxed load. */
+#define EXCHANGE(ptr, val) __atomic_exchange_n(ptr, val, __ATOMIC_ACQ_REL)
+#define LOAD_RELAXED(ptr)  __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#endif
+
+/** Initialize triple buffer struct.
+ *
+ * The three frames are zeroed, so the reader gets a zeroed frame until the
+ * first one is published.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to triple buffer.
+ * @param buff Pointer to the buffer (must be TRIPLEBUFFER_BUFSZ(size) bytes
+ * long).
+ * @param size Size of a frame.
+ */
+void TripleBuffer_init(struct TripleBuffer_t *o, void *buff, Size_t size)
+{
+    ASSERT(size != 0U);
+
+    o->Buff = (uint8_t*)buff;
+    o->Size = size;
+    o->Write = 0U;
+    o->State = 1U;
+    o->Read = 2U;
+    memset(buff, 0, TRIPLEBUFFER_BUFSZ(size));
+}
+
+/** Get the frame to be filled by the writer.
+ *
+ * The frame changes after each TripleBuffer_publish().
+ *
+ * Note: Must be called only by the writer.
+ *
+ * @param o Pointer to triple buffer.
+ * @return Pointer to the frame.
+ */
+void *TripleBuffer_writebuf(const struct TripleBuffer_t *o)
+{
+    return &o->Buff[o->Write * o->Size];
+}
+
+/** Publish the frame filled by the writer as the latest one.
+ *
+ * Never waits. The frame published before it is discarded if the reader has
+ * not taken it.
+ *
+ * Note: Must be called only by the writer.
+ *
+ * @param o Pointer to triple buffer.
+ */
+void TripleBuffer_publish(struct TripleBuffer_t *o)
+{
+    uint8_t state;
+#if (TRIPLEBUFFER_CAS_ENABLE != 0)
+    state = EXCHANGE(&o->State, (uint8_t)(o->Write | TRIPLEBUFFER_NEW));
+#else
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        state = o->State;
+        o->State = o->Write | TRIPLEBUFFER_NEW;
+    }
+    CRITICAL_EXIT();
+#endif
+    o->Write = state & 0x03U;
+
+    WAKE_OBJECT(o);
+}
+
+/** Take the latest frame published, if the reader does not have it yet.
+ *
+ * Never waits. The frame returned by TripleBuffer_readbuf() changes only when
+ * this function returns 1U.
+ *
+ * Note: Must be called only by the reader.
+ *
+ * @param o Pointer to triple buffer.
+ * @return 1U if a new frame was taken, 0U otherwise.
+ */
+uint8_t TripleBuffer_update(struct TripleBuffer_t *o)
+{
+    uint8_t state;
+#if (TRIPLEBUFFER_CAS_ENABLE != 0)
+    if((LOAD_RELAXED(&o->State) & TRIPLEBUFFER_NEW) == 0U)
+        return 0U;
+    state = EXCHANGE(&o->State, o->Read);
+#else
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        state = o->State;
+        if((state & TRIPLEBUFFER_NEW) != 0U)
+            o->State = o->Read;
+    }
+    CRITICAL_EXIT();
+
+    if((state & TRIPLEBUFFER_NEW) == 0U)
+        return 0U;
+#endif
+    o->Read = state & 0x03U;
+    return 1U;
+}
+
+/** Get the frame used by the reader.
+ *
+ * Note: Must be called only by the reader.
+ *
+ * @param o Pointer to triple buffer.
+ * @return Pointer to the latest frame taken by TripleBuffer_update().
+ */
+void *TripleBuffer_readbuf(const struct TripleBuffer_t *o)
+{
+    return &o->Buff[o->Read * o->Size];
+}
+
+#endif /* TRIPLEBUFFER_ENABLE */
@@ -0,0 +1,74 @@
+/*
+ Arduinutil TripleBuffer - Triple buffer implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_TRIPLEBUFFER_H__
+#define __ARDUINUTIL_TRIPLEBUFFER_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (TRIPLEBUFFER_ENABLE != 0)
+
+/* One writer publishes frames of Size bytes (a set of ADC channels, a sensor
+ reading) and one reader uses the latest complete frame. There are three
+ frames: the writer fills one, the reader uses another and the third holds the
+ latest frame published. Publishing swaps the frame of the writer with the
+ latest one and updating swaps the frame of the reader with it, so the frames
+ are never copied and neither side waits for the other:
+
+  frame = TripleBuffer_writebuf(&tb);      frame = TripleBuffer_readbuf(&tb);
+  ... fill frame ...                       if(TripleBuffer_update(&tb))
+  TripleBuffer_publish(&tb);                   frame = TripleBuffer_readbuf(&tb);
+
+ Frames published while the reader keeps its frame replace each other; only the
+ latest is read. State holds the index of the latest frame in bits 0-1 and
+ TRIPLEBUFFER_NEW while the reader has not taken it. With
+ TRIPLEBUFFER_CAS_ENABLE State is swapped with an atomic exchange, without
+ critical sections. */
+struct TripleBuffer_t {
+    uint8_t *Buff;
+    Size_t Size;
+    volatile uint8_t State;
+    uint8_t Write;
+    uint8_t Read;
+};
+
+#define TRIPLEBUFFER_NEW 0x04U
+
+/* Size of the buffer for frames of size bytes. */
+#define TRIPLEBUFFER_BUFSZ(size) (3U * (size))
+
+void TripleBuffer_init(struct TripleBuffer_t *o, void *buff, Size_t size);
+void *TripleBuffer_writebuf(const struct TripleBuffer_t *o);
+void TripleBuffer_publish(struct TripleBuffer_t *o);
+uint8_t TripleBuffer_update(struct TripleBuffer_t *o);
+void *TripleBuffer_readbuf(const struct TripleBuffer_t *o);
+
+#endif /* TRIPLEBUFFER_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_TRIPLEBUFFER_H__ */
@@ -0,0 +1,245 @@
+/*
+ Arduinutil TypedQueue - Compile-time typed queue implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_TYPEDQUEUE_H__
+#define __ARDUINUTIL_TYPEDQUEUE_H__
+
+#include "Arduinutil.h"
+#include "Data/queue.h"
+#include <stdint.h>
+
+/* QUEUE_DECLARE(name, type, length) declares struct name_t, a queue of length
+ items of type, and its functions name_init(), name_pushback(), etc. The API is
+ the one of SpscQueue_t, but the item size and the length are known at compile
+ time: length must be a power of two (at most half the maximum value of
+ Size_t), the position of an item is found by masking the free-running Head and
+ Tail counters and items are copied by assignment. Small items are pushed and
+ popped by a few inlined instructions, which matters in interrupt handlers.
+
+ As SpscQueue_t, the queue has no critical sections and is safe with one
+ producer and one consumer.
+
+ Example:
+ QUEUE_DECLARE(ByteQueue, uint8_t, 64U)
+ static struct ByteQueue_t Q;
+ ByteQueue_init(&Q);
+ ByteQueue_write(&Q, &data);
+
+ With QUEUE_STATS_ENABLE the queue also keeps a struct QueueStats_t, read by
+ name_getstats() and cleared by name_resetstats().
+ */
+
+#define TYPEDQUEUE_LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define TYPEDQUEUE_STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
+#if (QUEUE_STATS_ENABLE != 0)
+
+#define TYPEDQUEUE_STATS_FIELD struct QueueStats_t Stats;
+
+#define TYPEDQUEUE_STATS_FUNCTIONS(name)                                       \
+static __inline void name##_getstats(const struct name##_t *o,                 \
+        struct QueueStats_t *stats)                                            \
+{                                                                              \
+    *stats = o->Stats;                                                         \
+}                                                                              \
+                                                                               \
+static __inline void name##_resetstats(struct name##_t *o)                     \
+{                                                                              \
+    QUEUESTATS_RESET(&o->Stats);                                               \
+}
+
+#else
+
+#define TYPEDQUEUE_STATS_FIELD
+#define TYPEDQUEUE_STATS_FUNCTIONS(name)
+
+#endif /* QUEUE_STATS_ENABLE */
+
+#define QUEUE_DECLARE(name, type, length)                                      \
+                                                                               \
+typedef char name##_length_check[                                              \
+        ((length) != 0U && ((length) & ((length) - 1U)) == 0U &&               \
+        (length) <= ((Size_t)-1) / 2U + 1U) ? 1 : -1];                         \
+                                                                               \
+struct name##_t {                                                              \
+    volatile Size_t Head;                                                      \
+    volatile Size_t Tail;                                                      \
+    type Buff[length];                                                         \
+    TYPEDQUEUE_STATS_FIELD                                                     \
+};                                                                             \
+                                                                               \
+static __inline void name##_init(struct name##_t *o)                           \
+{                                                                              \
+    o->Head = 0U;                                                              \
+    o->Tail = 0U;                                                              \
+    QUEUESTATS_RESET(&o->Stats);                                               \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_used(const struct name##_t *o)                   \
+{                                                                              \
+    return (Size_t)(TYPEDQUEUE_LOAD_ACQUIRE(&o->Tail) -                        \
+            TYPEDQUEUE_LOAD_ACQUIRE(&o->Head));                                \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_free(const struct name##_t *o)                   \
+{                                                                              \
+    return (Size_t)((length) - name##_used(o));                                \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_pushback(struct name##_t *o, const type *val)   \
+{                                                                              \
+    Size_t tail = o->Tail;                                                     \
+    Size_t used = (Size_t)(tail - TYPEDQUEUE_LOAD_ACQUIRE(&o->Head));          \
+    if(used == (length))                                                       \
+    {                                                                          \
+        QUEUESTATS_PUSH_FAILED(&o->Stats, 1U);                                 \
+        return 0U;                                                             \
+    }                                                                          \
+    o->Buff[tail & ((length) - 1U)] = *val;                                    \
+    TYPEDQUEUE_STORE_RELEASE(&o->Tail, (Size_t)(tail + 1U));                   \
+    QUEUESTATS_PUSHED(&o->Stats, used + 1U, 1U);                               \
+    return 1U;                                                                 \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_popfront(struct name##_t *o, type *val)         \
+{                                                                              \
+    Size_t head = o->Head;                                                     \
+    if(head == TYPEDQUEUE_LOAD_ACQUIRE(&o->Tail))                              \
+    {                                                                          \
+        QUEUESTATS_POP_FAILED(&o->Stats);                                      \
+        return 0U;                                                             \
+    }                                                                          \
+    *val = o->Buff[head & ((length) - 1U)];                                    \
+    TYPEDQUEUE_STORE_RELEASE(&o->Head, (Size_t)(head + 1U));                   \
+    return 1U;                                                                 \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_pushback_n(struct name##_t *o,                   \
+        const type *buff, Size_t num)                                          \
+{                                                                              \
+    Size_t tail = o->Tail;                                                     \
+    Size_t used = (Size_t)(tail - TYPEDQUEUE_LOAD_ACQUIRE(&o->Head));          \
+    Size_t free = (Size_t)((length) - used);                                   \
+    Size_t i;                                                                  \
+    if(num > free)                                                             \
+    {                                                                          \
+        QUEUESTATS_PUSH_FAILED(&o->Stats, num - free);                         \
+        num = free;                                                            \
+    }                                                                          \
+    for(i = 0U; i < num; ++i)                                                  \
+        o->Buff[(Size_t)(tail + i) & ((length) - 1U)] = buff[i];               \
+    TYPEDQUEUE_STORE_RELEASE(&o->Tail, (Size_t)(tail + num));                  \
+    if(num != 0U)                                                              \
+        QUEUESTATS_PUSHED(&o->Stats, used + num, num);                         \
+    return num;                                                                \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_popfront_n(struct name##_t *o,                   \
+        type *buff, Size_t num)                                                \
+{                                                                              \
+    Size_t head = o->Head;                                                     \
+    Size_t used = (Size_t)(TYPEDQUEUE_LOAD_ACQUIRE(&o->Tail) - head);          \
+    Size_t i;                                                                  \
+    if(num > used)                                                             \
+    {                                                                          \
+        if(used == 0U)                                                         \
+            QUEUESTATS_POP_FAILED(&o->Stats);                                  \
+        num = used;                                                            \
+    }                                                                          \
+    for(i = 0U; i < num; ++i)                                                  \
+        buff[i] = o->Buff[(Size_t)(head + i) & ((length) - 1U)];               \
+    TYPEDQUEUE_STORE_RELEASE(&o->Head, (Size_t)(head + num));                  \
+    return num;                                                                \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_reserve(struct name##_t *o, Size_t num,         \
+        type **ptr, Size_t *contig)                                            \
+{                                                                              \
+    Size_t tail = o->Tail;                                                     \
+    Size_t left = (Size_t)((length) - (tail & ((length) - 1U)));               \
+    if((Size_t)((length) -                                                     \
+            (Size_t)(tail - TYPEDQUEUE_LOAD_ACQUIRE(&o->Head))) < num)         \
+        return 0U;                                                             \
+    *ptr = &o->Buff[tail & ((length) - 1U)];                                   \
+    *contig = (num < left) ? num : left;                                       \
+    return 1U;                                                                 \
+}                                                                              \
+                                                                               \
+static __inline void name##_commit(struct name##_t *o, Size_t num)             \
+{                                                                              \
+    Size_t tail = o->Tail;                                                     \
+    Size_t used = (Size_t)(tail - TYPEDQUEUE_LOAD_ACQUIRE(&o->Head));          \
+    TYPEDQUEUE_STORE_RELEASE(&o->Tail, (Size_t)(tail + num));                  \
+    QUEUESTATS_PUSHED(&o->Stats, used + num, num);                             \
+    (void)used;                                                                \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_peek(struct name##_t *o, Size_t num,            \
+        type **ptr, Size_t *contig)                                            \
+{                                                                              \
+    Size_t head = o->Head;                                                     \
+    Size_t left = (Size_t)((length) - (head & ((length) - 1U)));               \
+    if((Size_t)(TYPEDQUEUE_LOAD_ACQUIRE(&o->Tail) - head) < num)               \
+        return 0U;                                                             \
+    *ptr = &o->Buff[head & ((length) - 1U)];                                   \
+    *contig = (num < left) ? num : left;                                       \
+    return 1U;                                                                 \
+}                                                                              \
+                                                                               \
+static __inline void name##_release(struct name##_t *o, Size_t num)            \
+{                                                                              \
+    TYPEDQUEUE_STORE_RELEASE(&o->Head, (Size_t)(o->Head + num));               \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_write(struct name##_t *o, const type *val)      \
+{                                                                              \
+    return name##_pushback(o, val);                                            \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_read(struct name##_t *o, type *val)             \
+{                                                                              \
+    return name##_popfront(o, val);                                            \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_write_n(struct name##_t *o,                      \
+        const type *buff, Size_t num)                                          \
+{                                                                              \
+    return name##_pushback_n(o, buff, num);                                    \
+}                                                                              \
+                                                                               \
+static __inline Size_t name##_read_n(struct name##_t *o,                       \
+        type *buff, Size_t num)                                                \
+{                                                                              \
+    return name##_popfront_n(o, buff, num);                                    \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_empty(const struct name##_t *o)                 \
+{                                                                              \
+    return name##_used(o) == 0U;                                               \
+}                                                                              \
+                                                                               \
+static __inline uint8_t name##_full(const struct name##_t *o)                  \
+{                                                                              \
+    return name##_used(o) == (length);                                         \
+}                                                                              \
+                                                                               \
+TYPEDQUEUE_STATS_FUNCTIONS(name)
+
+#endif /* __ARDUINUTIL_TYPEDQUEUE_H__ */
@@ -0,0 +1,147 @@
+/*
+ Arduinutil Wait - Blocking waits with timeout implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#include "Data/wait.h"
+
+#if (WAIT_ENABLE != 0)
+
+#if (TIMER_ENABLE != 0)
+/* The timeouts are converted as whole seconds and the rest of a second, so that
+ the port macros, which may compute in 32 bits, do not overflow. */
+#define COUNTS_PER_S (F_CPU / TIMER_PRESCALER)
+
+static uint32_t waitMsToCounts(uint32_t ms)
+{
+    uint32_t sec = ms / 1000UL;
+    uint32_t counts = TIMER_MS_TO_COUNT(ms % 1000UL);
+
+    if(sec > (WAIT_MAX_COUNTS - counts) / COUNTS_PER_S)
+        return WAIT_MAX_COUNTS;
+    return sec * COUNTS_PER_S + counts;
+}
+
+static uint32_t waitCountsToMs(uint32_t counts)
+{
+    return counts / COUNTS_PER_S * 1000UL + TIMER_COUNT_TO_MS(counts % COUNTS_PER_S);
+}
+#endif
+
+/** Start waiting for an object.
+ *
+ * Must be called before the first try of the operation, so that a change of the
+ * object between the try and Wait_sleep() is not lost.
+ *
+ * Note: Finite timeouts are measured with the timer, which must be running
+ * (see timerBegin()). Without TIMER_ENABLE only 0U and WAIT_FOREVER can be
+ * used.
+ *
+ * @param w Pointer to wait struct.
+ * @param obj Pointer to object, or NULL to wait for any object to be woken.
+ * @param timeout_ms Timeout in milliseconds (WAIT_FOREVER waits forever).
+ * Timeouts longer than WAIT_MAX_COUNTS timer counts are cut to it.
+ */
+void Wait_begin(struct Wait_t *w, const volatile void *obj, uint32_t timeout_ms)
+{
+    w->Obj = obj;
+    w->Token = (obj != NULL) ? WAIT_BEGIN(obj) : WAIT_ANY_BEGIN();
+
+    if(timeout_ms == WAIT_FOREVER)
+    {
+        w->Timeout = WAIT_FOREVER;
+        w->Start = 0U;
+    }
+    else
+    {
+        #if (TIMER_ENABLE != 0)
+        {
+            w->Timeout = waitMsToCounts(timeout_ms);
+            w->Start = timerCounts();
+        }
+        #else
+        {
+            ASSERT(timeout_ms == 0U); /* Finite timeout needs the timer. */
+            w->Timeout = 0U;
+            w->Start = 0U;
+        }
+        #endif
+    }
+}
+
+/** Sleep until the object is woken or the timeout expires.
+ *
+ * @param w Pointer to wait struct.
+ * @return 1U if the operation should be tried again, 0U if the timeout expired.
+ */
+uint8_t Wait_sleep(struct Wait_t *w)
+{
+    uint32_t remaining_ms = WAIT_FOREVER;
+
+    if(w->Timeout != WAIT_FOREVER)
+    {
+        uint32_t elapsed;
+
+        if(w->Timeout == 0U)
+            return 0U;
+
+        #if (TIMER_ENABLE != 0)
+        {
+            elapsed = timerCounts() - w->Start;
+        }
+        #else
+        {
+            elapsed = 0U;
+        }
+        #endif
+
+        if(elapsed >= w->Timeout)
+            return 0U;
+        #if (TIMER_ENABLE != 0)
+        {
+            remaining_ms = waitCountsToMs(w->Timeout - elapsed) + 1U;
+        }
+        #endif
+    }
+
+    if(w->Obj != NULL)
+    {
+        WAIT_OBJECT(w->Obj, w->Token, remaining_ms);
+        w->Token = WAIT_TOKEN(w->Obj);
+    }
+    else
+    {
+        WAIT_ANY(w->Token, remaining_ms);
+        w->Token = WAIT_ANY_TOKEN();
+    }
+    return 1U;
+}
+
+/** Stop waiting for an object.
+ *
+ * @param w Pointer to wait struct.
+ */
+void Wait_end(struct Wait_t *w)
+{
+    if(w->Obj != NULL)
+        WAIT_END(w->Obj);
+    else
+        WAIT_ANY_END();
+}
+
+#endif /* WAIT_ENABLE */
@@ -0,0 +1,94 @@
+/*
+ Arduinutil Wait - Blocking waits with timeout implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+
+#ifndef __ARDUINUTIL_WAIT_H__
+#define __ARDUINUTIL_WAIT_H__
+
+#include "Arduinutil.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The blocking functions (Queue_popfront_wait(), Semaphore_lock_wait(), etc)
+ try the operation and, while it fails, sleep until the object is changed or
+ the timeout expires. The functions that change an object call WAKE_OBJECT().
+
+ The port may provide the sleep with the macros below. The GCC_Linux port parks
+ the thread on a futex. Otherwise the processor sleeps until the next
+ interrupt with WAIT_INT() (or just yields), which is enough when the object is
+ changed by an interrupt handler.
+
+ WAIT_BEGIN(obj)  Register a waiter of obj and return a token.
+ WAIT_TOKEN(obj)  Return a new token.
+ WAIT_OBJECT(obj, token, timeout_ms) Sleep unless obj was woken since token.
+ WAIT_END(obj)    Unregister a waiter of obj.
+ WAKE_OBJECT(obj) Wake the waiters of obj.
+
+ WAIT_ANY_BEGIN(), WAIT_ANY_TOKEN(), WAIT_ANY(token, timeout_ms) and
+ WAIT_ANY_END() do the same for a waiter of any object (see WaitSet_t), woken
+ by every WAKE_OBJECT() and interrupt.
+
+ Finite timeouts are kept in timer counts, so the longest one is
+ WAIT_MAX_COUNTS counts: about 76 h on the ATmega ports (16 MHz / 1024),
+ 4.7 h on GCC_Linux (16 MHz / 64) and 35 min on the MSP430 (16 MHz / 8).
+ Longer timeouts are cut to it. */
+#ifndef WAKE_OBJECT
+    #define WAIT_BEGIN(obj)  0U
+    #define WAIT_TOKEN(obj)  0U
+    #ifdef WAIT_INT
+        #define WAIT_OBJECT(obj, token, timeout_ms) \
+            do{ (void)(timeout_ms); WAIT_INT(); }while(0U)
+    #else
+        #define WAIT_OBJECT(obj, token, timeout_ms) \
+            do{ (void)(timeout_ms); YIELD(); }while(0U)
+    #endif
+    #define WAIT_END(obj)    do{}while(0U)
+    #define WAKE_OBJECT(obj) do{}while(0U)
+    #define WAIT_ANY_BEGIN() 0U
+    #define WAIT_ANY_TOKEN() 0U
+    #define WAIT_ANY(token, timeout_ms) WAIT_OBJECT(NULL, token, timeout_ms)
+    #define WAIT_ANY_END()   do{}while(0U)
+#endif
+
+#define WAIT_FOREVER 0xFFFFFFFFUL
+#define WAIT_MAX_COUNTS (WAIT_FOREVER - 1UL)
+
+#if (WAIT_ENABLE != 0)
+
+struct Wait_t {
+    const volatile void *Obj;
+    uint32_t Token;
+    uint32_t Timeout; /* Timer counts. */
+    uint32_t Start;   /* Timer counts. */
+};
+
+void Wait_begin(struct Wait_t *w, const volatile void *obj, uint32_t timeout_ms);
+uint8_t Wait_sleep(struct Wait_t *w);
+void Wait_end(struct Wait_t *w);
+
+#endif /* WAIT_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_WAIT_H__ */
@@ -0,0 +1,218 @@
+/*
+ Arduinutil WaitSet - Wait for several objects implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Data/waitset.h"
+#include "Data/wait.h"
+
+#if (WAITSET_ENABLE != 0 && WAIT_ENABLE != 0)
+
+enum {
+    WAITSET_QUEUE,
+    WAITSET_SEMAPHORE,
+    WAITSET_MAILBOX,
+    WAITSET_EVENTGROUP,
+    WAITSET_FUNC
+};
+
+static uint8_t waitSetAdd(struct WaitSet_t *o, uint8_t type, const void *obj,
+        Size_t (*func)(void))
+{
+    struct WaitSetItem_t *item;
+
+    if(o->Num == WAITSET_MAX)
+        return 0U;
+
+    item = &o->Items[o->Num];
+    item->Type = type;
+    item->Obj = obj;
+    item->Func = func;
+#if (EVENTGROUP_ENABLE != 0)
+    item->Bits = 0U;
+#endif
+    return (uint8_t)(1U << (o->Num)++);
+}
+
+/** Initialize wait-set struct.
+ *
+ * Note: Not thread-safe.
+ *
+ * @param o Pointer to wait-set.
+ */
+void WaitSet_init(struct WaitSet_t *o)
+{
+    o->Num = 0U;
+}
+
+#if (QUEUE_ENABLE != 0)
+
+/** Add a queue to the wait-set. It is ready when it is not empty.
+ *
+ * @param o Pointer to wait-set.
+ * @param queue Pointer to queue.
+ * @return Bit of the queue in the masks returned, 0U if the wait-set is full.
+ */
+uint8_t WaitSet_addqueue(struct WaitSet_t *o, const struct Queue_t *queue)
+{
+    return waitSetAdd(o, WAITSET_QUEUE, queue, NULL);
+}
+
+#endif /* QUEUE_ENABLE */
+
+#if (SEMAPHORE_ENABLE != 0)
+
+/** Add a semaphore to the wait-set. It is ready when it can be locked.
+ *
+ * @param o Pointer to wait-set.
+ * @param sem Pointer to semaphore.
+ * @return Bit of the semaphore in the masks returned, 0U if the wait-set is
+ * full.
+ */
+uint8_t WaitSet_addsemaphore(struct WaitSet_t *o, const struct Semaphore_t *sem)
+{
+    return waitSetAdd(o, WAITSET_SEMAPHORE, sem, NULL);
+}
+
+#endif /* SEMAPHORE_ENABLE */
+
+#if (MAILBOX_ENABLE != 0)
+
+/** Add a mailbox to the wait-set. It is ready when it has a message.
+ *
+ * @param o Pointer to wait-set.
+ * @param mbox Pointer to mailbox.
+ * @return Bit of the mailbox in the masks returned, 0U if the wait-set is
+ * full.
+ */
+uint8_t WaitSet_addmailbox(struct WaitSet_t *o, const struct Mailbox_t *mbox)
+{
+    return waitSetAdd(o, WAITSET_MAILBOX, mbox, NULL);
+}
+
+#endif /* MAILBOX_ENABLE */
+
+#if (EVENTGROUP_ENABLE != 0)
+
+/** Add an event group to the wait-set. It is ready when any of bits is set.
+ *
+ * The flags are not cleared; use EventGroup_poll() after the wait.
+ *
+ * @param o Pointer to wait-set.
+ * @param events Pointer to event group.
+ * @param bits Flags to wait for.
+ * @return Bit of the event group in the masks returned, 0U if the wait-set is
+ * full.
+ */
+uint8_t WaitSet_addeventgroup(struct WaitSet_t *o, const struct EventGroup_t *events,
+        uint32_t bits)
+{
+    uint8_t mask = waitSetAdd(o, WAITSET_EVENTGROUP, events, NULL);
+    if(mask != 0U)
+        o->Items[o->Num - 1U].Bits = bits;
+    return mask;
+}
+
+#endif /* EVENTGROUP_ENABLE */
+
+/** Add a function to the wait-set. It is ready when the function returns
+ * non-zero, e.g. Serial_available().
+ *
+ * Note: The function must check state changed by interrupts or by the objects
+ * that call WAKE_OBJECT(), otherwise the wait-set is not woken.
+ *
+ * @param o Pointer to wait-set.
+ * @param ready Pointer to function.
+ * @return Bit of the function in the masks returned, 0U if the wait-set is
+ * full.
+ */
+uint8_t WaitSet_addfunc(struct WaitSet_t *o, Size_t (*ready)(void))
+{
+    return waitSetAdd(o, WAITSET_FUNC, NULL, ready);
+}
+
+/** Check which objects of the wait-set are ready, without waiting.
+ *
+ * @param o Pointer to wait-set.
+ * @return Mask of the ready objects.
+ */
+uint8_t WaitSet_poll(const struct WaitSet_t *o)
+{
+    uint8_t mask = 0U;
+    uint8_t i;
+
+    for(i = 0U; i < o->Num; ++i)
+    {
+        const struct WaitSetItem_t *item = &o->Items[i];
+        uint8_t ready = 0U;
+
+        switch(item->Type)
+        {
+        #if (QUEUE_ENABLE != 0)
+        case WAITSET_QUEUE:
+            ready = Queue_used((const struct Queue_t*)item->Obj) != 0U;
+            break;
+        #endif
+        #if (SEMAPHORE_ENABLE != 0)
+        case WAITSET_SEMAPHORE:
+            ready = Semaphore_getcount((const struct Semaphore_t*)item->Obj) != 0U;
+            break;
+        #endif
+        #if (MAILBOX_ENABLE != 0)
+        case WAITSET_MAILBOX:
+            ready = ((const struct Mailbox_t*)item->Obj)->Msg != NULL;
+            break;
+        #endif
+        #if (EVENTGROUP_ENABLE != 0)
+        case WAITSET_EVENTGROUP:
+            ready = (EventGroup_get((const struct EventGroup_t*)item->Obj) & item->Bits) != 0U;
+            break;
+        #endif
+        default:
+            ready = item->Func() != 0U;
+            break;
+        }
+
+        if(ready != 0U)
+            mask |= (uint8_t)(1U << i);
+    }
+    return mask;
+}
+
+/** Wait until some objects of the wait-set are ready.
+ *
+ * Note: Must not be called with interrupts disabled.
+ *
+ * @param o Pointer to wait-set.
+ * @param timeout_ms Maximum time to wait in milliseconds (WAIT_FOREVER waits
+ * forever). See Wait_begin().
+ * @return Mask of the ready objects, 0U if the timeout expired.
+ */
+uint8_t WaitSet_wait(const struct WaitSet_t *o, uint32_t timeout_ms)
+{
+    struct Wait_t w;
+    uint8_t mask;
+
+    Wait_begin(&w, NULL, timeout_ms);
+    while((mask = WaitSet_poll(o)) == 0U && Wait_sleep(&w) != 0U)
+    {
+    }
+    Wait_end(&w);
+    return mask;
+}
+
+#endif /* WAITSET_ENABLE && WAIT_ENABLE */
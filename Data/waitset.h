@@ -0,0 +1,87 @@
+/*
+ Arduinutil WaitSet - Wait for several objects implementation in C
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_WAITSET_H__
+#define __ARDUINUTIL_WAITSET_H__
+
+#include "Arduinutil.h"
+#include "Data/queue.h"
+#include "Data/semphr.h"
+#include "Data/mailbox.h"
+#include "Data/eventgroup.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (WAITSET_ENABLE != 0 && WAIT_ENABLE != 0)
+
+/* A wait-set holds up to WAITSET_MAX objects: queues (ready when not empty),
+ semaphores (ready when they can be locked), mailboxes (ready when they have a
+ message), event groups (ready when any of the given flags is set) and
+ functions such as Serial_available() (ready when they return non-zero).
+ WaitSet_wait() sleeps until one of them is ready and returns a mask with a
+ bit for each ready one; the bit of an object is returned when it is added.
+
+ The objects are not changed: after the wait the caller pops, locks or
+ receives from the ready ones as usual. The microcontroller sleeps with
+ WAIT_INT() until an interrupt. On GCC_Linux the thread sleeps on a single
+ futex woken by every WAKE_OBJECT() and interrupt. */
+#define WAITSET_MAX 8U
+
+struct WaitSetItem_t {
+    uint8_t Type;
+    const void *Obj;
+    Size_t (*Func)(void);
+#if (EVENTGROUP_ENABLE != 0)
+    uint32_t Bits;
+#endif
+};
+
+struct WaitSet_t {
+    uint8_t Num;
+    struct WaitSetItem_t Items[WAITSET_MAX];
+};
+
+void WaitSet_init(struct WaitSet_t *o);
+#if (QUEUE_ENABLE != 0)
+    uint8_t WaitSet_addqueue(struct WaitSet_t *o, const struct Queue_t *queue);
+#endif
+#if (SEMAPHORE_ENABLE != 0)
+    uint8_t WaitSet_addsemaphore(struct WaitSet_t *o, const struct Semaphore_t *sem);
+#endif
+#if (MAILBOX_ENABLE != 0)
+    uint8_t WaitSet_addmailbox(struct WaitSet_t *o, const struct Mailbox_t *mbox);
+#endif
+#if (EVENTGROUP_ENABLE != 0)
+    uint8_t WaitSet_addeventgroup(struct WaitSet_t *o, const struct EventGroup_t *events,
+            uint32_t bits);
+#endif
+uint8_t WaitSet_addfunc(struct WaitSet_t *o, Size_t (*ready)(void));
+uint8_t WaitSet_poll(const struct WaitSet_t *o);
+uint8_t WaitSet_wait(const struct WaitSet_t *o, uint32_t timeout_ms);
+
+#endif /* WAITSET_ENABLE && WAIT_ENABLE */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_WAITSET_H__ */
@@ -0,0 +1,875 @@
+/*
+ Arduinutil - Data/ and Misc/ benchmark suite on the host port
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Build and run from the repository root:
+
+ $ gcc -O2 -I. -Iport/GCC_Linux -Dhexdump_write=benchHexdumpWrite \
+     bench/data.c port/GCC_Linux/[A-Z]*.c Data/[a-z]*.c Misc/[a-z]*.c \
+     -o data_bench -lpthread
+ $ ./data_bench [-c] [-n ops] [-f filter]
+
+ -c         Print comma separated values (one header line, one line per case).
+ -n ops     Operations per thread (default 1000000).
+ -f filter  Run only the cases whose name contains filter.
+
+ Every case is run for each item size and thread count that applies to it:
+ - single: each thread repeats the operation on the shared object (for the
+ queues an operation is a push and a pop, for the locks a lock and an unlock,
+ for the free lists a pop and a push);
+ - pair: thread 0 produces and thread 1 consumes, an operation is one item
+ transferred.
+
+ For each case it reports ns/op (over all threads), throughput in millions of
+ operations per second and percentiles of the latency. The latency is sampled
+ per batch of BENCH_BATCH operations (the clock costs about as much as the
+ cheaper operations), so it is the average of the batch; in the pair cases
+ only the producer is sampled. The bulk cases (_n) move BENCH_BULK items per
+ call and report per item. */
+
+#include "Arduinutil.h"
+#include "Simulation.h"
+#include "Data/queue.h"
+#include "Data/spscqueue.h"
+#include "Data/typedqueue.h"
+#include "Data/mpmcqueue.h"
+#include "Data/recqueue.h"
+#include "Data/bipbuffer.h"
+#include "Data/bcastring.h"
+#include "Data/prioqueue.h"
+#include "Data/semphr.h"
+#include "Data/mutex.h"
+#include "Data/mailbox.h"
+#include "Data/eventgroup.h"
+#include "Data/pool.h"
+#include "Data/lfstack.h"
+#include "Data/triplebuffer.h"
+#include "Data/wait.h"
+#include "Misc/convintstr.h"
+#include "Misc/hexdump.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_OPS        1000000UL
+#define BENCH_BATCH      64U
+#define BENCH_BULK       16U
+#define BENCH_LENGTH     64U
+#define BENCH_MAXITEM    64U
+#define BENCH_MAXTHREADS 8U
+#define BENCH_BYTES      1024U
+
+struct BenchCase_t {
+    const char *Name;
+    uint8_t Pair;
+    void (*Setup)(Size_t item_size);
+    void (*Run)(unsigned id, unsigned long n);
+};
+
+struct Worker_t {
+    pthread_t Thread;
+    unsigned Id;
+    const struct BenchCase_t *Case;
+    unsigned long Ops;
+    double *Samples;
+    unsigned long NumSamples;
+    uint64_t Start;
+    uint64_t End;
+};
+
+static Size_t ItemSize;
+static uint8_t Src[BENCH_MAXITEM * BENCH_BULK];
+static uint8_t Dst[BENCH_MAXTHREADS][BENCH_MAXITEM * BENCH_BULK];
+static pthread_barrier_t Barrier;
+
+static uint8_t QueueBuff[BENCH_LENGTH * BENCH_MAXITEM];
+static struct Queue_t Queue;
+static struct SpscQueue_t SpscQueue;
+#if (MPMCQUEUE_ENABLE != 0)
+static Size_t MpmcBuff[MPMCQUEUE_BUFSZ(BENCH_LENGTH, BENCH_MAXITEM) / sizeof(Size_t)];
+static struct MpmcQueue_t MpmcQueue;
+#endif
+static uint8_t ByteBuff[BENCH_BYTES];
+static struct RecQueue_t RecQueue;
+static struct BipBuffer_t BipBuffer;
+static struct BcastRing_t BcastRing;
+static struct BcastReader_t BcastReader;
+static uint32_t PrioBuff[PRIOQUEUE_BUFSZ(BENCH_LENGTH, BENCH_MAXITEM) / sizeof(uint32_t)];
+static struct PrioQueue_t PrioQueue;
+static struct Semaphore_t Semaphore;
+static struct Mutex_t Mutex;
+static struct Mailbox_t Mailbox;
+static struct MultiMailbox_t MultiMailbox;
+static void *MultiMailboxSlots[16];
+static struct EventGroup_t EventGroup;
+static struct Pool_t Pool;
+static void *PoolBuff[POOL_BUFSZ(64U, 64U) / sizeof(void*)];
+#if (LFSTACK_ENABLE != 0)
+static struct LfStack_t LfStack;
+static uint32_t LfStackNext[BENCH_LENGTH];
+#endif
+static struct Mutex_t FreeListLock;
+static Size_t FreeList[BENCH_LENGTH];
+static Size_t FreeListUsed;
+static struct TripleBuffer_t TripleBuffer;
+static uint8_t TripleBufferBuff[TRIPLEBUFFER_BUFSZ(BENCH_MAXITEM)];
+static struct Mutex_t FrameLock;
+static uint8_t Frame[BENCH_MAXITEM];
+static unsigned long HexdumpBytes;
+
+struct Item8_t { uint8_t b[8]; };
+struct Item64_t { uint8_t b[64]; };
+QUEUE_DECLARE(Typed1, uint8_t, BENCH_LENGTH)
+QUEUE_DECLARE(Typed8, struct Item8_t, BENCH_LENGTH)
+QUEUE_DECLARE(Typed64, struct Item64_t, BENCH_LENGTH)
+static struct Typed1_t Typed1;
+static struct Typed8_t Typed8;
+static struct Typed64_t Typed64;
+
+int benchHexdumpWrite(const void *str)
+{
+    HexdumpBytes += strlen((const char*)str);
+    return 0;
+}
+
+/* Queue_t */
+
+static void queueSetup(Size_t item_size)
+{
+    Queue_init(&Queue, QueueBuff, BENCH_LENGTH, item_size);
+}
+
+static void queueRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        while(!Queue_pushback(&Queue, Src))
+            sched_yield();
+        while(!Queue_popfront(&Queue, Dst[id]))
+            sched_yield();
+    }
+}
+
+static void queuePairRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        if(id == 0U)
+            while(!Queue_pushback(&Queue, Src))
+                sched_yield();
+        else
+            while(!Queue_popfront(&Queue, Dst[id]))
+                sched_yield();
+    }
+}
+
+static void queueBulkRun(unsigned id, unsigned long n)
+{
+    for(; n >= BENCH_BULK; n -= BENCH_BULK)
+    {
+        Queue_pushback_n(&Queue, Src, BENCH_BULK);
+        Queue_popfront_n(&Queue, Dst[id], BENCH_BULK);
+    }
+}
+
+static void queueBulkPairRun(unsigned id, unsigned long n)
+{
+    while(n != 0U)
+    {
+        Size_t num = (n < BENCH_BULK) ? (Size_t)n : BENCH_BULK;
+        if(id == 0U)
+            num = Queue_pushback_n(&Queue, Src, num);
+        else
+            num = Queue_popfront_n(&Queue, Dst[id], num);
+        if(num == 0U)
+            sched_yield();
+        n -= num;
+    }
+}
+
+static void queueOverwriteRun(unsigned id, unsigned long n)
+{
+    Size_t dropped;
+    (void)id;
+    while(n-- != 0U)
+        Queue_pushback_overwrite(&Queue, Src, &dropped);
+}
+
+/* SpscQueue_t */
+
+static void spscSetup(Size_t item_size)
+{
+    SpscQueue_init(&SpscQueue, QueueBuff, BENCH_LENGTH, item_size);
+}
+
+static void spscRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        SpscQueue_pushback(&SpscQueue, Src);
+        SpscQueue_popfront(&SpscQueue, Dst[id]);
+    }
+}
+
+static void spscPairRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        if(id == 0U)
+            while(!SpscQueue_pushback(&SpscQueue, Src))
+                sched_yield();
+        else
+            while(!SpscQueue_popfront(&SpscQueue, Dst[id]))
+                sched_yield();
+    }
+}
+
+static void spscBulkRun(unsigned id, unsigned long n)
+{
+    for(; n >= BENCH_BULK; n -= BENCH_BULK)
+    {
+        SpscQueue_pushback_n(&SpscQueue, Src, BENCH_BULK);
+        SpscQueue_popfront_n(&SpscQueue, Dst[id], BENCH_BULK);
+    }
+}
+
+static void spscBulkPairRun(unsigned id, unsigned long n)
+{
+    while(n != 0U)
+    {
+        Size_t num = (n < BENCH_BULK) ? (Size_t)n : BENCH_BULK;
+        if(id == 0U)
+            num = SpscQueue_pushback_n(&SpscQueue, Src, num);
+        else
+            num = SpscQueue_popfront_n(&SpscQueue, Dst[id], num);
+        if(num == 0U)
+            sched_yield();
+        n -= num;
+    }
+}
+
+/* Typed queues (the item size selects the queue type) */
+
+static void typedSetup(Size_t item_size)
+{
+    Typed1_init(&Typed1);
+    Typed8_init(&Typed8);
+    Typed64_init(&Typed64);
+    (void)item_size;
+}
+
+#define TYPED_RUN(q, type)                                                     \
+    do{                                                                        \
+        type *in = (type*)Src;                                                 \
+        type *out = (type*)Dst[id];                                            \
+        while(n-- != 0U)                                                       \
+        {                                                                      \
+            if(pair == 0U || id == 0U)                                         \
+                while(!q##_pushback(&q, in))                                   \
+                    sched_yield();                                             \
+            if(pair == 0U || id != 0U)                                         \
+                while(!q##_popfront(&q, out))                                  \
+                    sched_yield();                                             \
+        }                                                                      \
+    }while(0U)
+
+static void typedRunAny(unsigned id, unsigned long n, uint8_t pair)
+{
+    if(ItemSize == 1U)
+        TYPED_RUN(Typed1, uint8_t);
+    else if(ItemSize == 8U)
+        TYPED_RUN(Typed8, struct Item8_t);
+    else
+        TYPED_RUN(Typed64, struct Item64_t);
+}
+
+static void typedRun(unsigned id, unsigned long n)
+{
+    typedRunAny(id, n, 0U);
+}
+
+static void typedPairRun(unsigned id, unsigned long n)
+{
+    typedRunAny(id, n, 1U);
+}
+
+/* MpmcQueue_t */
+
+#if (MPMCQUEUE_ENABLE != 0)
+
+static void mpmcSetup(Size_t item_size)
+{
+    MpmcQueue_init(&MpmcQueue, MpmcBuff, BENCH_LENGTH, item_size);
+}
+
+static void mpmcRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        while(!MpmcQueue_pushback(&MpmcQueue, Src))
+            sched_yield();
+        while(!MpmcQueue_popfront(&MpmcQueue, Dst[id]))
+            sched_yield();
+    }
+}
+
+static void mpmcPairRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        if(id == 0U)
+            while(!MpmcQueue_pushback(&MpmcQueue, Src))
+                sched_yield();
+        else
+            while(!MpmcQueue_popfront(&MpmcQueue, Dst[id]))
+                sched_yield();
+    }
+}
+
+#endif /* MPMCQUEUE_ENABLE */
+
+/* RecQueue_t (records of item size bytes) */
+
+static void recSetup(Size_t item_size)
+{
+    (void)item_size;
+    RecQueue_init(&RecQueue, ByteBuff, BENCH_BYTES);
+}
+
+static void recRun(unsigned id, unsigned long n)
+{
+    Size_t length;
+    while(n-- != 0U)
+    {
+        RecQueue_push(&RecQueue, Src, ItemSize);
+        RecQueue_pop(&RecQueue, Dst[id], sizeof(Dst[id]), &length);
+    }
+}
+
+static void recPairRun(unsigned id, unsigned long n)
+{
+    Size_t length;
+    while(n-- != 0U)
+    {
+        if(id == 0U)
+            while(!RecQueue_push(&RecQueue, Src, ItemSize))
+                sched_yield();
+        else
+            while(!RecQueue_pop(&RecQueue, Dst[id], sizeof(Dst[id]), &length))
+                sched_yield();
+    }
+}
+
+/* BipBuffer_t (blocks of item size bytes) */
+
+static void bipSetup(Size_t item_size)
+{
+    (void)item_size;
+    BipBuffer_init(&BipBuffer, ByteBuff, BENCH_BYTES);
+}
+
+static void bipRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        BipBuffer_write(&BipBuffer, Src, ItemSize);
+        BipBuffer_read(&BipBuffer, Dst[id], ItemSize);
+    }
+}
+
+static void bipPairRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        Size_t done = 0U;
+        while(done < ItemSize)
+        {
+            Size_t num;
+            if(id == 0U)
+                num = BipBuffer_write(&BipBuffer, &Src[done], ItemSize - done);
+            else
+                num = BipBuffer_read(&BipBuffer, &Dst[id][done], ItemSize - done);
+            if(num == 0U)
+                sched_yield();
+            done += num;
+        }
+    }
+}
+
+/* BcastRing_t */
+
+static void bcastSetup(Size_t item_size)
+{
+    BcastRing_init(&BcastRing, QueueBuff, BENCH_LENGTH, item_size);
+    BcastRing_attach(&BcastRing, &BcastReader);
+}
+
+static void bcastRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        BcastRing_write(&BcastRing, Src);
+        BcastRing_read(&BcastRing, &BcastReader, Dst[id]);
+    }
+}
+
+/* PrioQueue_t (half full, so that push and pop sift through the heap) */
+
+static void prioSetup(Size_t item_size)
+{
+    uint32_t key;
+    PrioQueue_init(&PrioQueue, PrioBuff, BENCH_LENGTH, item_size);
+    for(key = 0U; key < BENCH_LENGTH / 2U; ++key)
+        PrioQueue_push(&PrioQueue, key * 2654435761UL % 1000U, Src, NULL);
+}
+
+static void prioRun(unsigned id, unsigned long n)
+{
+    uint32_t key = 0U;
+    while(n-- != 0U)
+    {
+        key += 2654435761UL;
+        PrioQueue_push(&PrioQueue, key % 1000U, Src, NULL);
+        PrioQueue_pop(&PrioQueue, NULL, Dst[id]);
+    }
+}
+
+/* Semaphore_t, Mutex_t, Mailbox_t, MultiMailbox_t and EventGroup_t */
+
+static void semSetup(Size_t item_size)
+{
+    (void)item_size;
+    Semaphore_initbinary(&Semaphore);
+    Semaphore_unlock(&Semaphore);
+}
+
+static void semRun(unsigned id, unsigned long n)
+{
+    (void)id;
+    while(n-- != 0U)
+    {
+        while(!Semaphore_lock(&Semaphore))
+            sched_yield();
+        Semaphore_unlock(&Semaphore);
+    }
+}
+
+static void mutexSetup(Size_t item_size)
+{
+    (void)item_size;
+    Mutex_init(&Mutex);
+}
+
+static void mutexRun(unsigned id, unsigned long n)
+{
+    (void)id;
+    while(n-- != 0U)
+    {
+        while(!Mutex_lock(&Mutex))
+            sched_yield();
+        Mutex_unlock(&Mutex);
+    }
+}
+
+static void mailboxSetup(Size_t item_size)
+{
+    (void)item_size;
+    Mailbox_init(&Mailbox);
+}
+
+static void mailboxRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        while(!Mailbox_send(&Mailbox, Dst[id]))
+            sched_yield();
+        while(Mailbox_receive(&Mailbox) == NULL)
+            sched_yield();
+    }
+}
+
+static void multiMailboxSetup(Size_t item_size)
+{
+    (void)item_size;
+    MultiMailbox_init(&MultiMailbox, MultiMailboxSlots, 16U);
+}
+
+static void multiMailboxRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        while(!MultiMailbox_send(&MultiMailbox, Dst[id]))
+            sched_yield();
+        while(MultiMailbox_receive(&MultiMailbox) == NULL)
+            sched_yield();
+    }
+}
+
+static void eventSetup(Size_t item_size)
+{
+    (void)item_size;
+    EventGroup_init(&EventGroup);
+}
+
+static void eventRun(unsigned id, unsigned long n)
+{
+    uint32_t bit = 1UL << id;
+    while(n-- != 0U)
+    {
+        EventGroup_set(&EventGroup, bit);
+        EventGroup_poll(&EventGroup, bit, EVENTGROUP_ANY | EVENTGROUP_CLEAR);
+    }
+}
+
+/* Pool_t */
+
+static void poolSetup(Size_t item_size)
+{
+    (void)item_size;
+    Pool_init(&Pool, PoolBuff, 64U, 64U);
+}
+
+static void poolRun(unsigned id, unsigned long n)
+{
+    void *block;
+    (void)id;
+    while(n-- != 0U)
+    {
+        while((block = Pool_alloc(&Pool)) == NULL)
+            sched_yield();
+        Pool_free(&Pool, block);
+    }
+#if (POOL_CACHE_ENABLE != 0)
+    Pool_flushcache(&Pool);
+#endif
+}
+
+/* LfStack_t against a free list guarded by a Mutex_t. An operation is a pop
+ and a push of an index. */
+
+#if (LFSTACK_ENABLE != 0)
+
+static void lfStackSetup(Size_t item_size)
+{
+    (void)item_size;
+    LfStack_init(&LfStack, LfStackNext, BENCH_LENGTH, 1U);
+}
+
+static void lfStackRun(unsigned id, unsigned long n)
+{
+    Size_t index;
+    (void)id;
+    while(n-- != 0U)
+    {
+        while((index = LfStack_pop(&LfStack)) == LFSTACK_EMPTY)
+            sched_yield();
+        LfStack_push(&LfStack, index);
+    }
+}
+
+#endif /* LFSTACK_ENABLE */
+
+static void freeListSetup(Size_t item_size)
+{
+    (void)item_size;
+    Mutex_init(&FreeListLock);
+    for(FreeListUsed = 0U; FreeListUsed < BENCH_LENGTH; ++FreeListUsed)
+        FreeList[FreeListUsed] = FreeListUsed;
+}
+
+static void freeListRun(unsigned id, unsigned long n)
+{
+    Size_t index;
+    (void)id;
+    while(n-- != 0U)
+    {
+        Mutex_lock_wait(&FreeListLock, WAIT_FOREVER);
+        index = FreeList[--FreeListUsed];
+        Mutex_unlock(&FreeListLock);
+
+        Mutex_lock_wait(&FreeListLock, WAIT_FOREVER);
+        FreeList[FreeListUsed++] = index;
+        Mutex_unlock(&FreeListLock);
+    }
+}
+
+/* TripleBuffer_t against a frame guarded by a Mutex_t. Thread 0 writes and
+ publishes frames of item size bytes, thread 1 takes and reads the latest. */
+
+static void tripleSetup(Size_t item_size)
+{
+    TripleBuffer_init(&TripleBuffer, TripleBufferBuff, item_size);
+}
+
+static void tripleRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        if(id == 0U)
+        {
+            memcpy(TripleBuffer_writebuf(&TripleBuffer), Src, ItemSize);
+            TripleBuffer_publish(&TripleBuffer);
+        }
+        else
+        {
+            TripleBuffer_update(&TripleBuffer);
+            memcpy(Dst[id], TripleBuffer_readbuf(&TripleBuffer), ItemSize);
+        }
+    }
+}
+
+static void frameSetup(Size_t item_size)
+{
+    (void)item_size;
+    Mutex_init(&FrameLock);
+}
+
+static void frameRun(unsigned id, unsigned long n)
+{
+    while(n-- != 0U)
+    {
+        Mutex_lock_wait(&FrameLock, WAIT_FOREVER);
+        if(id == 0U)
+            memcpy(Frame, Src, ItemSize);
+        else
+            memcpy(Dst[id], Frame, ItemSize);
+        Mutex_unlock(&FrameLock);
+    }
+}
+
+/* Misc/ */
+
+static void nopSetup(Size_t item_size)
+{
+    (void)item_size;
+}
+
+static void convRun(unsigned id, unsigned long n)
+{
+    uint32_t val = 4000000000UL;
+    while(n-- != 0U)
+    {
+        conv_ul2str((char*)Dst[id], 11U, val, 10U);
+        val += 12345U;
+    }
+}
+
+static void hexdumpRun(unsigned id, unsigned long n)
+{
+    (void)id;
+    while(n-- != 0U)
+        hexdump(Src, (uint16_t)ItemSize, 16U, 1U);
+}
+
+/* Cases and the item sizes and thread counts they are run with. The single
+ cases with more than one thread are listed only for the objects that allow
+ several producers and consumers. */
+
+struct BenchRun_t {
+    struct BenchCase_t Case;
+    Size_t Sizes[4];
+    unsigned Threads[4];
+};
+
+static const struct BenchRun_t Runs[] = {
+    { {"Queue", 0U, &queueSetup, &queueRun}, {1U, 8U, 64U}, {1U, 2U, 4U} },
+    { {"Queue pair", 1U, &queueSetup, &queuePairRun}, {1U, 8U, 64U}, {2U} },
+    { {"Queue_n", 0U, &queueSetup, &queueBulkRun}, {1U, 8U, 64U}, {1U} },
+    { {"Queue_n pair", 1U, &queueSetup, &queueBulkPairRun}, {1U, 8U, 64U}, {2U} },
+    { {"Queue overwrite", 0U, &queueSetup, &queueOverwriteRun}, {1U, 8U, 64U}, {1U} },
+    { {"Spsc", 0U, &spscSetup, &spscRun}, {1U, 8U, 64U}, {1U} },
+    { {"Spsc pair", 1U, &spscSetup, &spscPairRun}, {1U, 8U, 64U}, {2U} },
+    { {"Spsc_n", 0U, &spscSetup, &spscBulkRun}, {1U, 8U, 64U}, {1U} },
+    { {"Spsc_n pair", 1U, &spscSetup, &spscBulkPairRun}, {1U, 8U, 64U}, {2U} },
+    { {"Typed", 0U, &typedSetup, &typedRun}, {1U, 8U, 64U}, {1U} },
+    { {"Typed pair", 1U, &typedSetup, &typedPairRun}, {1U, 8U, 64U}, {2U} },
+#if (MPMCQUEUE_ENABLE != 0)
+    { {"Mpmc", 0U, &mpmcSetup, &mpmcRun}, {1U, 8U, 64U}, {1U, 2U, 4U} },
+    { {"Mpmc pair", 1U, &mpmcSetup, &mpmcPairRun}, {1U, 8U, 64U}, {2U} },
+#endif
+    { {"RecQueue", 0U, &recSetup, &recRun}, {1U, 8U, 64U}, {1U} },
+    { {"RecQueue pair", 1U, &recSetup, &recPairRun}, {1U, 8U, 64U}, {2U} },
+    { {"BipBuffer", 0U, &bipSetup, &bipRun}, {1U, 8U, 64U}, {1U} },
+    { {"BipBuffer pair", 1U, &bipSetup, &bipPairRun}, {1U, 8U, 64U}, {2U} },
+    { {"BcastRing", 0U, &bcastSetup, &bcastRun}, {1U, 8U, 64U}, {1U} },
+    { {"PrioQueue", 0U, &prioSetup, &prioRun}, {1U, 8U, 64U}, {1U} },
+    { {"Semaphore", 0U, &semSetup, &semRun}, {0U}, {1U, 2U, 4U} },
+    { {"Mutex", 0U, &mutexSetup, &mutexRun}, {0U}, {1U, 2U, 4U} },
+    { {"Mailbox", 0U, &mailboxSetup, &mailboxRun}, {0U}, {1U, 2U, 4U} },
+    { {"MultiMailbox", 0U, &multiMailboxSetup, &multiMailboxRun}, {0U}, {1U, 2U, 4U} },
+    { {"EventGroup", 0U, &eventSetup, &eventRun}, {0U}, {1U, 2U, 4U} },
+    { {"Pool", 0U, &poolSetup, &poolRun}, {0U}, {1U, 2U, 4U} },
+#if (LFSTACK_ENABLE != 0)
+    { {"LfStack", 0U, &lfStackSetup, &lfStackRun}, {0U}, {1U, 2U, 4U, 8U} },
+#endif
+    { {"Mutex free list", 0U, &freeListSetup, &freeListRun}, {0U}, {1U, 2U, 4U, 8U} },
+    { {"TripleBuffer pair", 1U, &tripleSetup, &tripleRun}, {8U, 64U}, {2U} },
+    { {"Mutex frame pair", 1U, &frameSetup, &frameRun}, {8U, 64U}, {2U} },
+    { {"conv_ul2str", 0U, &nopSetup, &convRun}, {0U}, {1U} },
+    { {"hexdump", 0U, &nopSetup, &hexdumpRun}, {16U, 64U}, {1U} },
+};
+
+static void *worker(void *arg)
+{
+    struct Worker_t *w = (struct Worker_t*)arg;
+    unsigned long done;
+    unsigned long k = 0U;
+
+    pthread_barrier_wait(&Barrier);
+    w->Start = Sim_clockNs();
+    for(done = 0U; done < w->Ops; done += BENCH_BATCH)
+    {
+        uint64_t t0 = Sim_clockNs();
+        w->Case->Run(w->Id, BENCH_BATCH);
+        w->Samples[k++] = (double)(Sim_clockNs() - t0) / BENCH_BATCH;
+    }
+    w->End = Sim_clockNs();
+    w->NumSamples = k;
+    return NULL;
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, unsigned long num, unsigned p)
+{
+    unsigned long i = (num * p) / 100U;
+    return sorted[(i < num) ? i : num - 1U];
+}
+
+static void runCase(const struct BenchCase_t *c, Size_t item_size,
+        unsigned threads, unsigned long ops, uint8_t csv)
+{
+    struct Worker_t w[BENCH_MAXTHREADS];
+    unsigned long per_thread = ops / BENCH_BATCH;
+    unsigned long num = 0U;
+    unsigned long total;
+    uint64_t start, end;
+    double *samples;
+    double ns;
+    unsigned i;
+
+    ItemSize = item_size;
+    c->Setup(item_size);
+
+    samples = (double*)malloc(threads * per_thread * sizeof(double));
+    if(samples == NULL)
+        return;
+
+    pthread_barrier_init(&Barrier, NULL, threads);
+    for(i = 0U; i < threads; ++i)
+    {
+        w[i].Id = i;
+        w[i].Case = c;
+        w[i].Ops = per_thread * BENCH_BATCH;
+        w[i].Samples = &samples[i * per_thread];
+        pthread_create(&w[i].Thread, NULL, &worker, &w[i]);
+    }
+
+    start = (uint64_t)-1;
+    end = 0U;
+    for(i = 0U; i < threads; ++i)
+    {
+        pthread_join(w[i].Thread, NULL);
+        if(w[i].Start < start)
+            start = w[i].Start;
+        if(w[i].End > end)
+            end = w[i].End;
+        /* Pair cases: only the producer is sampled. */
+        if(c->Pair == 0U || i == 0U)
+        {
+            memmove(&samples[num], w[i].Samples, w[i].NumSamples * sizeof(double));
+            num += w[i].NumSamples;
+        }
+    }
+    pthread_barrier_destroy(&Barrier);
+
+    total = per_thread * BENCH_BATCH * ((c->Pair != 0U) ? 1U : threads);
+    ns = (double)(end - start) / total;
+    qsort(samples, num, sizeof(double), &compareDouble);
+
+    if(csv != 0U)
+        printf("%s,%u,%u,%lu,%.2f,%.3f,%.2f,%.2f,%.2f,%.2f\n",
+                c->Name, (unsigned)item_size, threads, total, ns, 1e3 / ns,
+                percentile(samples, num, 50U), percentile(samples, num, 90U),
+                percentile(samples, num, 99U), samples[num - 1U]);
+    else
+        printf("%-16s %4u %3u %9.2f %9.3f %9.2f %9.2f %9.2f %9.2f\n",
+                c->Name, (unsigned)item_size, threads, ns, 1e3 / ns,
+                percentile(samples, num, 50U), percentile(samples, num, 90U),
+                percentile(samples, num, 99U), samples[num - 1U]);
+    fflush(stdout);
+
+    free(samples);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long ops = BENCH_OPS;
+    const char *filter = NULL;
+    uint8_t csv = 0U;
+    unsigned r, s, t;
+    int i;
+
+    for(i = 1; i < argc; ++i)
+    {
+        if(strcmp(argv[i], "-c") == 0)
+            csv = 1U;
+        else if(strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            ops = strtoul(argv[++i], NULL, 0);
+        else if(strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [-c] [-n ops] [-f filter]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(ops < BENCH_BATCH)
+        ops = BENCH_BATCH;
+
+    init();
+    memset(Src, 0xA5, sizeof(Src));
+
+    if(csv != 0U)
+        printf("name,item_size,threads,ops,ns_per_op,mops_per_s,"
+                "p50_ns,p90_ns,p99_ns,max_ns\n");
+    else
+        printf("%-16s %4s %3s %9s %9s %9s %9s %9s %9s\n", "case", "size",
+                "thr", "ns/op", "Mop/s", "p50", "p90", "p99", "max");
+
+    for(r = 0U; r < sizeof(Runs) / sizeof(Runs[0]); ++r)
+    {
+        const struct BenchRun_t *run = &Runs[r];
+
+        if(filter != NULL && strstr(run->Case.Name, filter) == NULL)
+            continue;
+
+        for(s = 0U; s < 4U && (s == 0U || run->Sizes[s] != 0U); ++s)
+            for(t = 0U; t < 4U && run->Threads[t] != 0U; ++t)
+                runCase(&run->Case, run->Sizes[s], run->Threads[t], ops, csv);
+    }
+
+    return 0;
+}
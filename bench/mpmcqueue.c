@@ -0,0 +1,120 @@
+/*
+ Arduinutil - Queue_t versus MpmcQueue_t scaling benchmark on the host port
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Build and run from the repository root:
+
+ $ gcc -O2 -I. -Iport/GCC_Linux bench/mpmcqueue.c port/GCC_Linux/[A-Z]*.c \
+     Data/[a-z]*.c -o mpmcqueue_bench -lpthread
+ $ ./mpmcqueue_bench [max_threads]
+
+ From 1 to max_threads threads (default: number of online CPUs) share one
+ queue. Each thread pushes an item and pops an item in a loop, so every thread
+ is both a producer and a consumer. The time per operation and the total
+ throughput are printed for Queue_t (serialized by the critical sections, a
+ global lock on the host) and MpmcQueue_t. */
+
+#include "Arduinutil.h"
+#include "Simulation.h"
+#include "Data/queue.h"
+#include "Data/mpmcqueue.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BENCH_LENGTH 1024U
+#define BENCH_OPS    200000UL /* Push/pop pairs per thread. */
+#define BENCH_MAX_THREADS 64U
+
+static uint32_t QueueBuff[BENCH_LENGTH];
+static Size_t MpmcBuff[MPMCQUEUE_BUFSZ(BENCH_LENGTH, sizeof(uint32_t)) / sizeof(Size_t)];
+static struct Queue_t Queue;
+static struct MpmcQueue_t MpmcQueue;
+
+static void *queueWorker(void *arg)
+{
+    uint32_t val = (uint32_t)(uintptr_t)arg;
+    unsigned long n;
+    for(n = 0U; n < BENCH_OPS; ++n)
+    {
+        while(!Queue_write(&Queue, &val))
+            sched_yield();
+        while(!Queue_read(&Queue, &val))
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void *mpmcWorker(void *arg)
+{
+    uint32_t val = (uint32_t)(uintptr_t)arg;
+    unsigned long n;
+    for(n = 0U; n < BENCH_OPS; ++n)
+    {
+        while(!MpmcQueue_write(&MpmcQueue, &val))
+            sched_yield();
+        while(!MpmcQueue_read(&MpmcQueue, &val))
+            sched_yield();
+    }
+    return NULL;
+}
+
+static void run(const char *name, void *(*worker)(void *), unsigned num)
+{
+    pthread_t threads[BENCH_MAX_THREADS];
+    uint64_t start, ns;
+    double ops = 2.0 * BENCH_OPS * num;
+    unsigned i;
+
+    start = Sim_clockNs();
+    for(i = 0U; i < num; ++i)
+        pthread_create(&threads[i], NULL, worker, (void *)(uintptr_t)i);
+    for(i = 0U; i < num; ++i)
+        pthread_join(threads[i], NULL);
+    ns = Sim_clockNs() - start;
+
+    printf("%-6s %3u threads %8.2f ns/op %8.2f Mops/s\n",
+            name, num, (double)ns / ops, ops * 1000.0 / (double)ns);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned max = (argc > 1) ? (unsigned)atoi(argv[1]) :
+            (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned num;
+
+    if(max == 0U)
+        max = 1U;
+    if(max > BENCH_MAX_THREADS)
+        max = BENCH_MAX_THREADS;
+
+    init();
+
+    for(num = 1U; num <= max; ++num)
+    {
+        Queue_init(&Queue, QueueBuff, BENCH_LENGTH, sizeof(uint32_t));
+        run("Queue", &queueWorker, num);
+
+        MpmcQueue_init(&MpmcQueue, MpmcBuff, BENCH_LENGTH, sizeof(uint32_t));
+        run("Mpmc", &mpmcWorker, num);
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ Arduinutil - Queue_t versus SpscQueue_t benchmark on the host port
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Build and run from the repository root:
+
+ $ gcc -O2 -I. -Iport/GCC_Linux bench/spscqueue.c port/GCC_Linux/[A-Z]*.c \
+     Data/[a-z]*.c -o spscqueue_bench -lpthread
+ $ ./spscqueue_bench
+
+ Two cases are measured for each queue, with 1 byte items as used by Serial:
+ - single: one thread pushes and pops (no contention, cost of the operations);
+ - pair: one thread pushes and another pops (the Serial producer/consumer). */
+
+#include "Arduinutil.h"
+#include "Simulation.h"
+#include "Data/queue.h"
+#include "Data/spscqueue.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define BENCH_LENGTH 64U
+#define BENCH_ITEMS  2000000UL
+
+static uint8_t Buff[BENCH_LENGTH];
+static struct Queue_t Queue;
+static struct SpscQueue_t SpscQueue;
+
+static void *queueConsumer(void *arg)
+{
+    unsigned long n = 0U;
+    uint8_t data;
+    (void)arg;
+    while(n < BENCH_ITEMS)
+    {
+        if(Queue_read(&Queue, &data))
+        {
+            if(data != (uint8_t)n++)
+                fprintf(stderr, "Queue_t: wrong item\n");
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *spscConsumer(void *arg)
+{
+    unsigned long n = 0U;
+    uint8_t data;
+    (void)arg;
+    while(n < BENCH_ITEMS)
+    {
+        if(SpscQueue_read(&SpscQueue, &data))
+        {
+            if(data != (uint8_t)n++)
+                fprintf(stderr, "SpscQueue_t: wrong item\n");
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void report(const char *name, uint64_t start)
+{
+    uint64_t ns = Sim_clockNs() - start;
+    printf("%-14s %8.2f ns/op\n", name, (double)ns / BENCH_ITEMS);
+}
+
+int main(void)
+{
+    pthread_t thread;
+    unsigned long n;
+    uint64_t start;
+    uint8_t data;
+
+    init();
+
+    Queue_init(&Queue, Buff, BENCH_LENGTH, 1U);
+    start = Sim_clockNs();
+    for(n = 0U; n < BENCH_ITEMS; ++n)
+    {
+        data = (uint8_t)n;
+        Queue_write(&Queue, &data);
+        Queue_read(&Queue, &data);
+    }
+    report("Queue single", start);
+
+    SpscQueue_init(&SpscQueue, Buff, BENCH_LENGTH, 1U);
+    start = Sim_clockNs();
+    for(n = 0U; n < BENCH_ITEMS; ++n)
+    {
+        data = (uint8_t)n;
+        SpscQueue_write(&SpscQueue, &data);
+        SpscQueue_read(&SpscQueue, &data);
+    }
+    report("Spsc single", start);
+
+    Queue_init(&Queue, Buff, BENCH_LENGTH, 1U);
+    start = Sim_clockNs();
+    pthread_create(&thread, NULL, &queueConsumer, NULL);
+    for(n = 0U; n < BENCH_ITEMS; ++n)
+    {
+        data = (uint8_t)n;
+        while(!Queue_write(&Queue, &data))
+            sched_yield();
+    }
+    pthread_join(thread, NULL);
+    report("Queue pair", start);
+
+    SpscQueue_init(&SpscQueue, Buff, BENCH_LENGTH, 1U);
+    start = Sim_clockNs();
+    pthread_create(&thread, NULL, &spscConsumer, NULL);
+    for(n = 0U; n < BENCH_ITEMS; ++n)
+    {
+        data = (uint8_t)n;
+        while(!SpscQueue_write(&SpscQueue, &data))
+            sched_yield();
+    }
+    pthread_join(thread, NULL);
+    report("Spsc pair", start);
+
+    return 0;
+}
@@ -34,10 +34,32 @@ extern "C" {
 #define MAILBOX_ENABLE               1
 #define SEMAPHORE_ENABLE             1
 #define MUTEX_ENABLE                 1
+#define SPSCQUEUE_ENABLE             1
+#define MPMCQUEUE_ENABLE             0 /* Needs compare-and-swap. */
+#define WAIT_ENABLE                  1 /* Blocking waits with timeout. */
+#define WAITSET_ENABLE               1 /* Wait for several objects (needs WAIT). */
+#define QUEUE_STATS_ENABLE           0 /* Queue statistics (Queue_getstats()). */
+#define RECQUEUE_ENABLE              1 /* Variable-length record queue. */
+#define BIPBUFFER_ENABLE             1 /* Bipartite buffer (contiguous regions). */
+#define BCASTRING_ENABLE             1 /* Single-writer multi-reader ring. */
+#define PRIOQUEUE_ENABLE             1 /* Priority queue (binary heap). */
+#define SEMAPHORE_CAS_ENABLE         0 /* Semaphore without critical sections (needs CAS). */
+#define MUTEX_STATS_ENABLE           0 /* Mutex owner and wait/hold time histograms. */
+#define SEQLOCK_ENABLE               1 /* Sequence lock (snapshots without critical sections). */
+#define EVENTGROUP_ENABLE            1 /* Event flag groups (wait for any/all). */
+#define CONDVAR_ENABLE               1 /* Condition variables (needs MUTEX and WAIT). */
+#define MAILBOX_CAS_ENABLE           0 /* Mailboxes without critical sections (needs CAS). */
+#define POOL_ENABLE                  1 /* Fixed-block memory pool. */
+#define POOL_CACHE_ENABLE            0 /* Per-thread caches of pool blocks. */
+#define LFSTACK_ENABLE               0 /* Lock-free stack (needs 64-bit CAS). */
+#define TRIPLEBUFFER_ENABLE          1 /* Triple buffer (latest frame, no copies). */
+#define TRIPLEBUFFER_CAS_ENABLE      0 /* Triple buffer without critical sections (needs exchange). */
 
 #define SERIAL_ENABLE                0
 #define SERIAL_RBUFSZ                64U
 #define SERIAL_TBUFSZ                64U
+#define SERIAL_QUEUE_SPSC            0 /* Lock-free queues for Serial buffers. */
+#define SERIAL_QUEUE_TYPED           0 /* Typed queues (power of two sizes). */
 #define SERIAL_PRINT_BUFSZ           32U
 
 #define SERIAL1_ENABLE               0
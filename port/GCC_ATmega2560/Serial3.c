@@ -22,19 +22,21 @@
 
 #include "Arduinutil.h"
 #include "Config.h"
-#include "Data/queue.h"
+#include "Arduinutil_Serial.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 #if (SERIAL3_ENABLE != 0)
 
-static uint8_t RxBuff_data[SERIAL3_RBUFSZ];
-static uint8_t TxBuff_data[SERIAL3_TBUFSZ];
-static struct Queue_t RxBuff;
-static struct Queue_t TxBuff;
+SERIAL_QUEUE_DECLARE(RxQueue, SERIAL3_RBUFSZ)
+SERIAL_QUEUE_DECLARE(TxQueue, SERIAL3_TBUFSZ)
+
+static struct RxQueue_t RxBuff;
+static struct TxQueue_t TxBuff;
 
 void Serial3_begin(uint32_t speed, uint32_t config)
 {
@@ -79,8 +81,8 @@ void Serial3_begin(uint32_t speed, uint32_t config)
 
     UCSR3B = 0; /* Disable TX and RX. */
 
-    Queue_init(&RxBuff, &RxBuff_data, sizeof(RxBuff_data), 1);
-    Queue_init(&TxBuff, &TxBuff_data, sizeof(TxBuff_data), 1);
+    RxQueue_init(&RxBuff);
+    TxQueue_init(&TxBuff);
 
     /* Set speed and other configurations. */
     UBRR3 = ubrr;
@@ -97,12 +99,12 @@ void Serial3_end(void)
 
 Size_t Serial3_available(void)
 {
-    return Queue_used(&RxBuff);
+    return RxQueue_used(&RxBuff);
 }
 
 void Serial3_flush(void)
 {
-    while(Queue_used(&TxBuff) != 0U)
+    while(TxQueue_used(&TxBuff) != 0U)
     {
         WAIT_INT();
     }
@@ -115,14 +117,14 @@ void Serial3_writeByte(uint8_t data)
     CRITICAL_ENTER();
 
     if(     (UCSR3A & (1U << UDRE3)) &&
-            Queue_empty(&TxBuff))
+            TxQueue_empty(&TxBuff))
     {
         UDR3 = data;
     }
     else
     {
         UCSR3B |= (1U << UDRIE3);
-        while(!Queue_write(&TxBuff, &data))
+        while(!TxQueue_write(&TxBuff, &data))
         {
             CRITICAL_EXIT();
 
@@ -135,53 +137,125 @@ void Serial3_writeByte(uint8_t data)
     CRITICAL_EXIT();
 }
 
+/* Enable the transmit interrupt, which sends the data in TxBuff. */
+static void usartTxStart(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    UCSR3B |= (1U << UDRIE3);
+    CRITICAL_EXIT();
+}
+
 void Serial3_write(const void *str)
 {
-    const uint8_t *s = (const uint8_t *)str;
-    while(*s != 0U)
-        Serial3_writeByte(*s++);
+    Serial3_writeBuff(str, strlen((const char *)str));
 }
 
 void Serial3_writeBuff(const void *buff, uint16_t length)
 {
     const uint8_t *b = (const uint8_t *)buff;
-    while(length-- != 0)
-        Serial3_writeByte(*b++);
+
+    while(length != 0U)
+    {
+        Size_t num = TxQueue_write_n(&TxBuff, b,
+                (length < SERIAL3_TBUFSZ) ? length : SERIAL3_TBUFSZ);
+        if(num != 0U)
+        {
+            b += num;
+            length -= num;
+            usartTxStart();
+        }
+        else
+        {
+            WAIT_INT();
+        }
+    }
 }
 
 int Serial3_print(const void *format, ...)
 {
-	int used_length;
-    char buf[SERIAL_PRINT_BUFSZ];
+    int used_length;
+    uint8_t *ptr;
+    Size_t contig;
+    va_list vl;
+
+    va_start(vl, format);
+    if(     TxQueue_reserve(&TxBuff, SERIAL3_PRINT_BUFSZ, &ptr, &contig) &&
+            contig == SERIAL3_PRINT_BUFSZ)
     {
-        va_list vl;
-        va_start(vl, format);
+        /* Format directly in the transmit buffer. */
+        used_length = vsnprintf((char *)ptr, SERIAL3_PRINT_BUFSZ, format, vl);
+        if(used_length > 0)
+        {
+            TxQueue_commit(&TxBuff, (used_length < (int)SERIAL3_PRINT_BUFSZ) ?
+                    (Size_t)used_length : SERIAL3_PRINT_BUFSZ - 1U);
+            usartTxStart();
+        }
+    }
+    else
+    {
+        char buf[SERIAL3_PRINT_BUFSZ];
         used_length = vsnprintf(buf, SERIAL3_PRINT_BUFSZ, format, vl);
-        va_end(vl);
+        Serial3_write(buf);
     }
-    Serial3_write(buf);
+    va_end(vl);
     return used_length;
 }
 
 int16_t Serial3_read(void)
 {
     uint8_t data;
-    if(Queue_read(&RxBuff, &data))
+    if(RxQueue_read(&RxBuff, &data))
         return data;
     else
         return -1;
 }
 
+uint16_t Serial3_readBuff(void *buff, uint16_t length)
+{
+    return RxQueue_read_n(&RxBuff, buff,
+            (length < SERIAL3_RBUFSZ) ? length : SERIAL3_RBUFSZ);
+}
+
+#if (QUEUE_STATS_ENABLE != 0)
+
+void Serial3_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_getstats(&RxBuff, rx);
+        TxQueue_getstats(&TxBuff, tx);
+    }
+    CRITICAL_EXIT();
+}
+
+void Serial3_resetStats(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_resetstats(&RxBuff);
+        TxQueue_resetstats(&TxBuff);
+    }
+    CRITICAL_EXIT();
+}
+
+#endif /* QUEUE_STATS_ENABLE */
+
 ISR(USART3_RX_vect)
 {
     uint8_t data = UDR3;
-    Queue_write(&RxBuff, &data);
+    RxQueue_write(&RxBuff, &data);
 }
 
 ISR(USART3_UDRE_vect)
 {
     uint8_t data;
-    if(Queue_read(&TxBuff, &data))
+    if(TxQueue_read(&TxBuff, &data))
         UDR3 = data;
     else
         UCSR3B &= ~(1U << UDRIE3);
@@ -22,19 +22,21 @@
 
 #include "Arduinutil.h"
 #include "Config.h"
-#include "Data/queue.h"
+#include "Arduinutil_Serial.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 #if (SERIAL_ENABLE != 0)
 
-static uint8_t RxBuff_data[SERIAL_RBUFSZ];
-static uint8_t TxBuff_data[SERIAL_TBUFSZ];
-static struct Queue_t RxBuff;
-static struct Queue_t TxBuff;
+SERIAL_QUEUE_DECLARE(RxQueue, SERIAL_RBUFSZ)
+SERIAL_QUEUE_DECLARE(TxQueue, SERIAL_TBUFSZ)
+
+static struct RxQueue_t RxBuff;
+static struct TxQueue_t TxBuff;
 
 void Serial_begin(uint32_t speed, uint32_t config)
 {
@@ -79,8 +81,8 @@ void Serial_begin(uint32_t speed, uint32_t config)
 
     UCSR0B = 0; /* Disable TX and RX. */
 
-    Queue_init(&RxBuff, &RxBuff_data, sizeof(RxBuff_data), 1);
-    Queue_init(&TxBuff, &TxBuff_data, sizeof(TxBuff_data), 1);
+    RxQueue_init(&RxBuff);
+    TxQueue_init(&TxBuff);
 
     /* Set speed and other configurations. */
     UBRR0 = ubrr;
@@ -97,12 +99,12 @@ void Serial_end(void)
 
 Size_t Serial_available(void)
 {
-    return Queue_used(&RxBuff);
+    return RxQueue_used(&RxBuff);
 }
 
 void Serial_flush(void)
 {
-    while(Queue_used(&TxBuff) != 0U)
+    while(TxQueue_used(&TxBuff) != 0U)
     {
         WAIT_INT();
     }
@@ -115,14 +117,14 @@ void Serial_writeByte(uint8_t data)
     CRITICAL_ENTER();
 
     if(     (UCSR0A & (1U << UDRE0)) &&
-            Queue_empty(&TxBuff))
+            TxQueue_empty(&TxBuff))
     {
         UDR0 = data;
     }
     else
     {
         UCSR0B |= (1U << UDRIE0);
-        while(!Queue_write(&TxBuff, &data))
+        while(!TxQueue_write(&TxBuff, &data))
         {
             CRITICAL_EXIT();
 
@@ -135,53 +137,125 @@ void Serial_writeByte(uint8_t data)
     CRITICAL_EXIT();
 }
 
+/* Enable the transmit interrupt, which sends the data in TxBuff. */
+static void usartTxStart(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    UCSR0B |= (1U << UDRIE0);
+    CRITICAL_EXIT();
+}
+
 void Serial_write(const void *str)
 {
-    const uint8_t *s = (const uint8_t *)str;
-    while(*s != 0U)
-        Serial_writeByte(*s++);
+    Serial_writeBuff(str, strlen((const char *)str));
 }
 
 void Serial_writeBuff(const void *buff, uint16_t length)
 {
     const uint8_t *b = (const uint8_t *)buff;
-    while(length-- != 0)
-        Serial_writeByte(*b++);
+
+    while(length != 0U)
+    {
+        Size_t num = TxQueue_write_n(&TxBuff, b,
+                (length < SERIAL_TBUFSZ) ? length : SERIAL_TBUFSZ);
+        if(num != 0U)
+        {
+            b += num;
+            length -= num;
+            usartTxStart();
+        }
+        else
+        {
+            WAIT_INT();
+        }
+    }
 }
 
 int Serial_print(const char *format, ...)
 {
     int used_length;
-    char buf[SERIAL_PRINT_BUFSZ];
+    uint8_t *ptr;
+    Size_t contig;
+    va_list vl;
+
+    va_start(vl, format);
+    if(     TxQueue_reserve(&TxBuff, SERIAL_PRINT_BUFSZ, &ptr, &contig) &&
+            contig == SERIAL_PRINT_BUFSZ)
+    {
+        /* Format directly in the transmit buffer. */
+        used_length = vsnprintf((char *)ptr, SERIAL_PRINT_BUFSZ, format, vl);
+        if(used_length > 0)
+        {
+            TxQueue_commit(&TxBuff, (used_length < (int)SERIAL_PRINT_BUFSZ) ?
+                    (Size_t)used_length : SERIAL_PRINT_BUFSZ - 1U);
+            usartTxStart();
+        }
+    }
+    else
     {
-        va_list vl;
-        va_start(vl, format);
+        char buf[SERIAL_PRINT_BUFSZ];
         used_length = vsnprintf(buf, SERIAL_PRINT_BUFSZ, format, vl);
-        va_end(vl);
+        Serial_write(buf);
     }
-    Serial_write(buf);
+    va_end(vl);
     return used_length;
 }
 
 int16_t Serial_read(void)
 {
     uint8_t data;
-    if(Queue_read(&RxBuff, &data))
+    if(RxQueue_read(&RxBuff, &data))
         return data;
     else
         return -1;
 }
 
+uint16_t Serial_readBuff(void *buff, uint16_t length)
+{
+    return RxQueue_read_n(&RxBuff, buff,
+            (length < SERIAL_RBUFSZ) ? length : SERIAL_RBUFSZ);
+}
+
+#if (QUEUE_STATS_ENABLE != 0)
+
+void Serial_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_getstats(&RxBuff, rx);
+        TxQueue_getstats(&TxBuff, tx);
+    }
+    CRITICAL_EXIT();
+}
+
+void Serial_resetStats(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_resetstats(&RxBuff);
+        TxQueue_resetstats(&TxBuff);
+    }
+    CRITICAL_EXIT();
+}
+
+#endif /* QUEUE_STATS_ENABLE */
+
 ISR(USART_RX_vect)
 {
     uint8_t data = UDR0;
-    Queue_write(&RxBuff, &data);
+    RxQueue_write(&RxBuff, &data);
 }
 
 ISR(USART_UDRE_vect)
 {
     uint8_t data;
-    if(Queue_read(&TxBuff, &data))
+    if(TxQueue_read(&TxBuff, &data))
         UDR0 = data;
     else
         UCSR0B &= ~(1U << UDRIE0);
@@ -23,12 +23,16 @@
 #include "Arduinutil.h"
 #include "Config.h"
 #include "Arduinutil_Timer.h"
+#include "Data/seqlock.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
 #if (TIMER_ENABLE != 0)
 
 static uint32_t TimerIntCount = 0U;
+#if (SEQLOCK_ENABLE != 0)
+static struct SeqLock_t TimerLock = SEQLOCK_INIT;
+#endif
 
 /** Enable Timer. */
 void timerBegin(void)
@@ -86,7 +90,13 @@ void timerEnd(void)
 
 ISR(TIMER0_OVF_vect)
 {
+#if (SEQLOCK_ENABLE != 0)
+    SeqLock_writebegin(&TimerLock);
     TimerIntCount += 1U;
+    SeqLock_writeend(&TimerLock);
+#else
+    TimerIntCount += 1U;
+#endif
 }
 
 /** Return the number of milliseconds the timer is running.
@@ -112,6 +122,19 @@ uint32_t timerCounts(void)
 {
     uint32_t timerIntCount;
     uint8_t timerCount;
+#if (SEQLOCK_ENABLE != 0)
+    Size_t seq;
+
+    /* Read again if the overflow interrupt ran meanwhile. With interrupts
+     disabled it cannot run and the overflow flag tells it is pending. */
+    do {
+        seq = SeqLock_readbegin(&TimerLock);
+        timerIntCount = TimerIntCount;
+        timerCount = TCNT0;
+        if(TIFR0 & (1U << TOV0))
+            timerCount = 255U;
+    } while(SeqLock_readretry(&TimerLock, seq) != 0U);
+#else
     CRITICAL_VAL();
 
     CRITICAL_ENTER();
@@ -122,6 +145,7 @@ uint32_t timerCounts(void)
             timerCount = 255U;
     }
     CRITICAL_EXIT();
+#endif
     return (timerIntCount * 256UL + timerCount);
 }
 
@@ -143,7 +167,13 @@ void timerAddSleepedCounts(uint32_t counts)
 
     CRITICAL_ENTER();
     {
+#if (SEQLOCK_ENABLE != 0)
+        SeqLock_writebegin(&TimerLock);
+        TimerIntCount += counts / 256UL;
+        SeqLock_writeend(&TimerLock);
+#else
         TimerIntCount += counts / 256UL;
+#endif
     }
     CRITICAL_EXIT();
 }
@@ -0,0 +1,127 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+
+#if (ANALOG_ENABLE != 0)
+
+/* Simulated 10 bit ADC. AnalogInput holds the value the converter reads on
+ each channel, set by the simulation with Sim_analogSetInput(). */
+static uint16_t AnalogInput[MAXANALOG];
+static uint8_t AdcEnabled = 0U;
+static uint8_t AdcReference = INTERNALVCC;
+static uint8_t AdcReady = 0U;
+static uint16_t AdcResult = 0U;
+
+/** Enable ADC. */
+void adcBegin(void)
+{
+    AdcEnabled = 1U;
+    AdcReady = 0U;
+
+    analogReference(INTERNALVCC);
+}
+
+/** Disable ADC. */
+void adcEnd(void)
+{
+    AdcEnabled = 0U;
+}
+
+/** Start an analog to digital conversion.
+
+ Note: The simulated conversion finishes immediately. */
+void analogConvertStart(uint8_t analog)
+{
+    CRITICAL_VAL();
+
+    ASSERT(AdcEnabled != 0U);
+    analog -= A0;
+    ASSERT(analog < MAXANALOG);
+
+    CRITICAL_ENTER();
+    {
+        AdcResult = AnalogInput[analog];
+        AdcReady = 1U;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Check if an analog to digital conversion has finished.
+
+ Return 1U if the conversion has finished, 0U otherwise. */
+uint8_t analogConvertReady(void)
+{
+    return AdcReady;
+}
+
+/** Get the value from the analog to digital conversion. */
+uint16_t analogConvertGetValue(void)
+{
+    return AdcResult;
+}
+
+/** Read and return an analog value. */
+uint16_t analogRead(uint8_t analog)
+{
+    analogConvertStart(analog);
+    while(!analogConvertReady())
+    {
+      WAIT_BUSY();
+    }
+    return analogConvertGetValue();
+}
+
+/** Set analog reference.
+
+ See enum AnalogReferences for the available references. */
+void analogReference(uint8_t reference)
+{
+    AdcReference = reference;
+}
+
+/** Simulation: set the value the ADC reads on a channel (0-1023).
+
+ Note: Use pin ANALOGIO+X for analog pin X. */
+void Sim_analogSetInput(uint8_t analog, uint16_t value)
+{
+    CRITICAL_VAL();
+
+    analog -= A0;
+    ASSERT(analog < MAXANALOG);
+
+    CRITICAL_ENTER();
+    {
+        AnalogInput[analog] = value & 0x03FFU;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Simulation: return the analog reference the application selected. */
+uint8_t Sim_analogGetReference(void)
+{
+    return AdcReference;
+}
+
+#endif /* ANALOG_ENABLE */
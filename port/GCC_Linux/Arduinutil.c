@@ -0,0 +1,108 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+#include <time.h>
+
+/* Port specific variable. Not declared as static because it is used in
+ Digital.c file. Bit X set means the digital input of analog pin X is
+ disabled. */
+uint32_t DigitalInputsDisabled = 0U;
+
+/** Microcontroller initialization. */
+void init(void)
+{
+    uint8_t io;
+
+    /* Configure all pins as input with pull-up, analog pins without pull-up
+     and with the digital inputs disabled. The same as the AVR ports. */
+    for(io = 0U; io < ANALOGIO; ++io)
+        pinMode(io, INPUT_PULLUP);
+    for(io = ANALOGIO; io < MAXIO; ++io)
+        pinMode(io, INPUT);
+
+    disableDigitalInputsOfAnalogPins(0xFFFFFFFF);
+    disablePeripheralsClocks();
+
+    INTERRUPTS_ENABLE();
+}
+
+/** Disable all peripherals clocks for lower power consumption.
+
+ Note: The simulated peripherals have no clock gating. */
+void disablePeripheralsClocks(void)
+{
+}
+
+/** Enable peripherals clocks. */
+void enablePeripheralsClocks(void)
+{
+}
+
+/** Disable digital inputs of analog pins for lower power consumption. */
+void disableDigitalInputsOfAnalogPins(uint32_t didr_bits)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        DigitalInputsDisabled |= didr_bits;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Enable digital inputs of analog pins.
+ *
+ * 0x00FF bits correspond to A7-A0
+ */
+void enableDigitalInputsOfAnalogPins(uint32_t didr_bits)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        DigitalInputsDisabled &= ~didr_bits;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Return a monotonic time stamp in nanoseconds. Used by the simulated
+ peripherals that depend on the passage of time. */
+uint64_t Sim_clockNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/** Convert nanoseconds to counts of a clock of rate counts per second.
+
+ Whole seconds and the rest are converted apart, so ns * rate does not
+ overflow after about 20 hours at 16 MHz. */
+uint64_t Sim_nsToCounts(uint64_t ns, uint32_t rate)
+{
+    return ns / 1000000000ULL * rate + ns % 1000000000ULL * rate / 1000000000ULL;
+}
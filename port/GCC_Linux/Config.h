@@ -32,10 +32,62 @@
 extern "C" {
 #endif
 
+/* Simulated CPU clock. Only used to convert timer counts. */
+#ifndef F_CPU
+#define F_CPU                        16000000UL
+#endif
+
 #define QUEUE_ENABLE                 1
 #define MAILBOX_ENABLE               1
 #define SEMAPHORE_ENABLE             1
 #define MUTEX_ENABLE                 1
+#define SPSCQUEUE_ENABLE             1
+#define MPMCQUEUE_ENABLE             1 /* Needs compare-and-swap. */
+#define WAIT_ENABLE                  1 /* Blocking waits with timeout. */
+#define WAITSET_ENABLE               1 /* Wait for several objects (needs WAIT). */
+#define QUEUE_STATS_ENABLE           0 /* Queue statistics (Queue_getstats()). */
+#define RECQUEUE_ENABLE              1 /* Variable-length record queue. */
+#define BIPBUFFER_ENABLE             1 /* Bipartite buffer (contiguous regions). */
+#define BCASTRING_ENABLE             1 /* Single-writer multi-reader ring. */
+#define PRIOQUEUE_ENABLE             1 /* Priority queue (binary heap). */
+#define SEMAPHORE_CAS_ENABLE         1 /* Semaphore without critical sections (needs CAS). */
+#define MUTEX_STATS_ENABLE           1 /* Mutex owner and wait/hold time histograms. */
+#define SEQLOCK_ENABLE               1 /* Sequence lock (snapshots without critical sections). */
+#define EVENTGROUP_ENABLE            1 /* Event flag groups (wait for any/all). */
+#define CONDVAR_ENABLE               1 /* Condition variables (needs MUTEX and WAIT). */
+#define MAILBOX_CAS_ENABLE           1 /* Mailboxes without critical sections (needs CAS). */
+#define POOL_ENABLE                  1 /* Fixed-block memory pool. */
+#define POOL_CACHE_ENABLE            1 /* Per-thread caches of pool blocks. */
+#define LFSTACK_ENABLE               1 /* Lock-free stack (needs 64-bit CAS). */
+#define TRIPLEBUFFER_ENABLE          1 /* Triple buffer (latest frame, no copies). */
+#define TRIPLEBUFFER_CAS_ENABLE      1 /* Triple buffer without critical sections (needs exchange). */
+
+#define SERIAL_ENABLE                1
+#define SERIAL_RBUFSZ                64U
+#define SERIAL_TBUFSZ                64U
+#define SERIAL_QUEUE_SPSC            0 /* Lock-free queues for Serial buffers. */
+#define SERIAL_QUEUE_TYPED           0 /* Typed queues (power of two sizes). */
+#define SERIAL_PRINT_BUFSZ           32U
+
+#define I2C_ENABLE                   1
+
+#define WATCHDOG_ENABLE              1
+#define WATCHDOG_AUTOINIT            0
+#define WATCHDOG_AUTOINIT_TIMEOUT    0U
+
+#define TIMER_ENABLE                 1
+#define TIMER_PRESCALER              64U
+
+#define ANALOG_ENABLE                1
+
+#define PWM_ENABLE                   1
+#define TIMER1_PRESCALER             1024U
+#define TIMER2_PRESCALER             1024U
+#define TIMER1_OVERFLOW_INTERRUPT    1
+#define TIMER2_OVERFLOW_INTERRUPT    1
+
+#define DIGITAL_EXTERNAL_INT_ENABLE  1
+#define DIGITAL_ATTACH_INT_ENABLE    1
 
 typedef size_t Size_t;
 
@@ -0,0 +1,326 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+
+extern uint32_t DigitalInputsDisabled; /* Arduinutil.c */
+
+/* Values of DriveList. */
+enum SimDriveValues {
+    SIM_DRIVE_LOW = LOW,
+    SIM_DRIVE_HIGH = HIGH,
+    SIM_DRIVE_NONE = 0xFFU /* Nothing outside drives the pin. */
+};
+
+/* Simulated port registers. The same meaning as the AVR DDR and PORT bits:
+ DdrList=1 is output; PortList is the output value or, for inputs, the
+ pull-up. DriveList is what the outside world applies to the pin. */
+static uint8_t DdrList[MAXIO];
+static uint8_t PortList[MAXIO];
+static uint8_t DriveList[MAXIO] = {
+        SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE,
+        SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE,
+        SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE,
+        SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE,
+        SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE, SIM_DRIVE_NONE
+};
+
+static void pinChanged(uint8_t io, uint8_t before, uint8_t after);
+
+/** Change pin configuration. The modes are INPUT, OUTPUT and INPUT_PULLUP.
+
+ Note: Use pin ANALOGIO+X for analog pin X. */
+void pinMode(uint8_t io, uint8_t mode)
+{
+    uint8_t before;
+    CRITICAL_VAL();
+
+    ASSERT(io < MAXIO);
+
+    CRITICAL_ENTER();
+
+    before = digitalRead(io);
+
+    switch(mode)
+    {
+    case INPUT:
+        DdrList[io] = 0U;
+        PortList[io] = 0U;
+        break;
+    case OUTPUT:
+        DdrList[io] = 1U;
+        break;
+    case INPUT_PULLUP:
+        DdrList[io] = 0U;
+        PortList[io] = 1U;
+        break;
+    default:
+        ASSERT(0); /* Invalid pin mode. */
+        break;
+    }
+
+    pinChanged(io, before, digitalRead(io));
+
+    CRITICAL_EXIT();
+}
+
+/** Change pin output value or input pull-up. The values are LOW and HIGH.
+
+ Note: Use pin ANALOGIO+X for analog pin X. */
+void digitalWrite(uint8_t io, uint8_t value)
+{
+    uint8_t before;
+    CRITICAL_VAL();
+
+    ASSERT(io < MAXIO);
+
+    CRITICAL_ENTER();
+
+    before = digitalRead(io);
+    PortList[io] = (value != LOW);
+    pinChanged(io, before, digitalRead(io));
+
+    CRITICAL_EXIT();
+}
+
+/** Read pin input value. The values returned are LOW and HIGH.
+
+ Note: Use pin ANALOGIO+X for analog pin X. */
+uint8_t digitalRead(uint8_t io)
+{
+    ASSERT(io < MAXIO);
+
+    if(io >= ANALOGIO && (DigitalInputsDisabled & (1UL << (io - ANALOGIO))) != 0U)
+        return LOW; /* Digital input buffer disabled. */
+    if(DdrList[io] != 0U)
+        return PortList[io];
+    if(DriveList[io] != SIM_DRIVE_NONE)
+        return DriveList[io];
+    return PortList[io]; /* Pull-up or floating (reads low). */
+}
+
+/** Simulation: apply a LOW or HIGH level to the pin from outside. */
+void Sim_digitalDrive(uint8_t io, uint8_t value)
+{
+    uint8_t before;
+    CRITICAL_VAL();
+
+    ASSERT(io < MAXIO);
+
+    CRITICAL_ENTER();
+    {
+        before = digitalRead(io);
+        DriveList[io] = (value != LOW) ? SIM_DRIVE_HIGH : SIM_DRIVE_LOW;
+        pinChanged(io, before, digitalRead(io));
+    }
+    CRITICAL_EXIT();
+}
+
+/** Simulation: stop driving the pin from outside. */
+void Sim_digitalRelease(uint8_t io)
+{
+    uint8_t before;
+    CRITICAL_VAL();
+
+    ASSERT(io < MAXIO);
+
+    CRITICAL_ENTER();
+    {
+        before = digitalRead(io);
+        DriveList[io] = SIM_DRIVE_NONE;
+        pinChanged(io, before, digitalRead(io));
+    }
+    CRITICAL_EXIT();
+}
+
+/** Simulation: return the level the microcontroller outputs on the pin. */
+uint8_t Sim_digitalGetOutput(uint8_t io)
+{
+    ASSERT(io < MAXIO);
+    return DdrList[io] != 0U && PortList[io] != 0U;
+}
+
+/** Simulation: return the mode of the pin (INPUT, OUTPUT or INPUT_PULLUP). */
+uint8_t Sim_digitalGetMode(uint8_t io)
+{
+    ASSERT(io < MAXIO);
+
+    if(DdrList[io] != 0U)
+        return OUTPUT;
+    else if(PortList[io] != 0U)
+        return INPUT_PULLUP;
+    else
+        return INPUT;
+}
+
+#if (DIGITAL_EXTERNAL_INT_ENABLE != 0)
+
+static uint32_t PinChangeMask = 0U;
+
+/** Enable external interrupt.
+
+ The processor interrupts whenever any of the enabled pins state changes.
+ All pins share a single interrupt handler, set with
+ Sim_digitalSetPinChangeIsr(). Therefore application must check by software
+ which pin changed and to what state. */
+void enableExternalInterrupt(uint8_t io)
+{
+    CRITICAL_VAL();
+
+    ASSERT(io < MAXIO);
+
+    CRITICAL_ENTER();
+    {
+        PinChangeMask |= (1UL << io);
+    }
+    CRITICAL_EXIT();
+}
+
+/** Disable external interrupt. */
+void disableExternalInterrupt(uint8_t io)
+{
+    CRITICAL_VAL();
+
+    ASSERT(io < MAXIO);
+
+    CRITICAL_ENTER();
+    {
+        PinChangeMask &= ~(1UL << io);
+    }
+    CRITICAL_EXIT();
+}
+
+/** Simulation: set the handler of the pin change interrupt. */
+void Sim_digitalSetPinChangeIsr(void (*isr)(void))
+{
+    Sim_interruptAttach(SIM_PCINT_VECT, isr);
+}
+
+#endif /* DIGITAL_EXTERNAL_INT_ENABLE */
+
+#if (DIGITAL_ATTACH_INT_ENABLE != 0)
+
+static uint8_t extIntMode[2U];
+static uint8_t extIntEnabled[2U];
+
+/** Convert a digital pin to a interrupt number.
+
+ In this implementation it does nothing other than avoid breaking people code.
+ */
+uint8_t digitalPinToInterrupt(uint8_t pin)
+{
+    return pin;
+}
+
+/** Enable external interrupt.
+
+ Only pins 2 and 3 are able to use this function.
+ isr is a pointer to the function to be called when the interrupt fires.
+ mode is the interrupt mode. See enum DigitalInterruptModes. */
+void attachInterrupt(uint8_t pin, void (*isr)(void), uint8_t mode)
+{
+    CRITICAL_VAL();
+
+    mode &= 0x03U;
+
+    CRITICAL_ENTER();
+
+    switch(pin) {
+    case 2U:
+    case 3U:
+        Sim_interruptAttach(SIM_INT0_VECT + (pin - 2U), isr);
+        extIntMode[pin - 2U] = mode;
+        extIntEnabled[pin - 2U] = 1U;
+        break;
+    default:
+        ASSERT(0); /* Invalid interrupt pin. */
+    }
+
+    CRITICAL_EXIT();
+}
+
+/** Disable external interrupt. */
+void detachInterrupt(uint8_t pin)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+
+    switch(pin) {
+    case 2U:
+    case 3U:
+        extIntEnabled[pin - 2U] = 0U;
+        break;
+    default:
+        ASSERT(0); /* Invalid interrupt pin. */
+    }
+
+    CRITICAL_EXIT();
+}
+
+#endif /* DIGITAL_ATTACH_INT_ENABLE */
+
+/* Raise the interrupts the level change of a pin triggers. Must be called with
+ interrupts disabled. */
+static void pinChanged(uint8_t io, uint8_t before, uint8_t after)
+{
+    #if (DIGITAL_ATTACH_INT_ENABLE != 0)
+    {
+        if(io == 2U || io == 3U)
+        {
+            uint8_t i = io - 2U;
+            uint8_t fire;
+
+            switch(extIntMode[i]) {
+            case LOW:
+                fire = (after == LOW);
+                break;
+            case CHANGE:
+                fire = (before != after);
+                break;
+            case FALLING:
+                fire = (before == HIGH && after == LOW);
+                break;
+            default: /* RISING */
+                fire = (before == LOW && after == HIGH);
+                break;
+            }
+
+            if(fire && extIntEnabled[i] != 0U)
+                Sim_interruptRaise(SIM_INT0_VECT + i);
+        }
+    }
+    #endif
+
+    #if (DIGITAL_EXTERNAL_INT_ENABLE != 0)
+    {
+        if(before != after && (PinChangeMask & (1UL << io)) != 0U)
+            Sim_interruptRaise(SIM_PCINT_VECT);
+    }
+    #endif
+
+    (void)io;
+    (void)before;
+    (void)after;
+}
@@ -0,0 +1,173 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+
+#if (I2C_ENABLE != 0)
+
+/* These are the status returned by I2c_getStatus() function. Zero means the I2C
+ peripheral is IDLE and non-zero means it is busy. */
+enum I2c_interrupt_status_t {
+    IDLE = 0U,
+    BUSY = 1U
+};
+
+/* Simulated bus. Devices[addr] is the slave that answers to addr. */
+static const struct SimI2cDevice_t *Devices[128U];
+static const struct SimI2cDevice_t *LastDevice = NULL;
+static uint8_t I2cStatus = IDLE;
+static uint8_t I2cEnabled = 0U;
+
+/** Initialize peripheral for communication.
+
+ @param speed Maximum speed the interface is allowed to use.
+ */
+void I2c_begin(uint32_t speed)
+{
+    ASSERT(speed != 0U);
+
+    I2cEnabled = 1U;
+    I2cStatus = IDLE;
+}
+
+/** Disable peripheral. */
+void I2c_end(void)
+{
+    I2cEnabled = 0U;
+}
+
+/** Return peripheral status. Zero means IDLE, busy otherwise. */
+uint8_t I2c_getStatus(void)
+{
+    return I2cStatus;
+}
+
+/** Send stop condition in the bus. */
+void I2c_stop(void)
+{
+    if(LastDevice != NULL && LastDevice->stop != NULL)
+        LastDevice->stop();
+    LastDevice = NULL;
+}
+
+/** Send start condition in the bus and send (write) up to 'length' bytes from
+ 'buff' to the device of address 'addr'. The value pointed by 'numsent' holds
+ the actual number of bytes sent. A stop condition is not sent by this function.
+
+ Note: The simulated transfer is finished when the function returns. */
+void I2c_write(uint8_t addr, const uint8_t *buff, uint8_t length, uint8_t *numsent)
+{
+    const struct SimI2cDevice_t *dev;
+    CRITICAL_VAL();
+
+    ASSERT(I2cEnabled != 0U);
+    ASSERT(addr < 128U);
+
+    CRITICAL_ENTER();
+    {
+        if(I2cStatus != IDLE)
+        {
+            CRITICAL_EXIT();
+            return;
+        }
+        I2cStatus = BUSY;
+    }
+    CRITICAL_EXIT();
+
+    *numsent = 0U;
+
+    dev = Devices[addr];
+    LastDevice = dev;
+    if(dev != NULL) /* SLA+W ACK. */
+    {
+        while(length-- != 0U)
+        {
+            uint8_t ack = dev->write(*buff++);
+            ++(*numsent);
+            if(ack == 0U)
+                break; /* Data NACK. */
+        }
+    }
+
+    I2cStatus = IDLE;
+}
+
+/** Send start condition in the bus and receive (read) up to 'length' bytes in
+ 'buff' from the device of address 'addr'. The value pointed by 'numread' holds
+ the actual number of bytes received. A stop condition is not sent by this
+ function.
+
+ Note: The simulated transfer is finished when the function returns. */
+void I2c_read(uint8_t addr, uint8_t *buff, uint8_t length, uint8_t *numread)
+{
+    const struct SimI2cDevice_t *dev;
+    CRITICAL_VAL();
+
+    ASSERT(I2cEnabled != 0U);
+    ASSERT(addr < 128U);
+
+    CRITICAL_ENTER();
+    {
+        if(I2cStatus != IDLE)
+        {
+            CRITICAL_EXIT();
+            return;
+        }
+        I2cStatus = BUSY;
+    }
+    CRITICAL_EXIT();
+
+    *numread = 0U;
+
+    dev = Devices[addr];
+    LastDevice = dev;
+    if(dev != NULL) /* SLA+R ACK. */
+    {
+        while(length-- != 0U)
+        {
+            *buff++ = dev->read();
+            ++(*numread);
+        }
+    }
+
+    I2cStatus = IDLE;
+}
+
+/** Simulation: connect a slave device to the bus. The struct must stay valid
+ while the device is attached. */
+void Sim_i2cAttach(uint8_t addr, const struct SimI2cDevice_t *dev)
+{
+    ASSERT(addr < 128U);
+    ASSERT(dev != NULL && dev->write != NULL && dev->read != NULL);
+    Devices[addr] = dev;
+}
+
+/** Simulation: disconnect a slave device from the bus. */
+void Sim_i2cDetach(uint8_t addr)
+{
+    ASSERT(addr < 128U);
+    Devices[addr] = NULL;
+}
+
+#endif /* I2C_ENABLE */
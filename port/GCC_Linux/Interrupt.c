@@ -0,0 +1,470 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#define _GNU_SOURCE
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+#include "Data/wait.h"
+#include <pthread.h>
+#include <sched.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+
+/* Simulated interrupt controller.
+
+ A single dispatcher thread plays the role of the CPU running interrupts: it
+ runs the handlers of the pending vectors, lowest vector number first.
+
+ "Interrupts disabled" is a lock. A thread that disables interrupts (with
+ CRITICAL_ENTER() or INTERRUPTS_DISABLE()) takes IntLock and marks itself with
+ IntDisabled. The dispatcher takes the same lock before running a handler, so a
+ handler never runs in the middle of a critical section of any thread and two
+ critical sections never run at the same time. Like the status register of the
+ microcontrollers, the state is saved and restored, so nested critical
+ sections only touch the lock on the outermost level. */
+
+/* IntLock values. */
+enum IntLockValues {
+    INTLOCK_FREE = 0,
+    INTLOCK_LOCKED = 1,
+    INTLOCK_CONTENDED = 2 /* Locked and there may be threads sleeping. */
+};
+
+#define INTLOCK_SPIN 100U
+#define WAIT_INT_TIMEOUT_NS 1000000U
+#define HANDOFF_YIELDS 1000U
+
+static int IntLock = INTLOCK_FREE;
+static __thread uint8_t IntDisabled = 0U;
+
+/* Statistics. Written only by the owner of IntLock. */
+static struct SimCriticalStats_t IntStats;
+
+/* Dispatcher. */
+static void (*IsrTable[SIM_NUM_VECT])(void);
+static uint64_t IsrDeadline[SIM_NUM_VECT];
+static uint32_t IntPending = 0U;
+static int IntWake = 0; /* Futex: changes when the dispatcher must wake. */
+static int IntSeq = 0;  /* Futex: changes after every interrupt run. */
+static uint32_t IntSeqWaiters = 0U;
+static pthread_mutex_t IntScheduleLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t IntDispatcherOnce = PTHREAD_ONCE_INIT;
+
+static long futexWait(int *addr, int val, uint64_t timeout_ns)
+{
+    struct timespec ts, *pts = NULL;
+    if(timeout_ns != 0U)
+    {
+        ts.tv_sec = (time_t)(timeout_ns / 1000000000ULL);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000ULL);
+        pts = &ts;
+    }
+    return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, pts, NULL, 0);
+}
+
+static long futexWake(int *addr, int num)
+{
+    return syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, num, NULL, NULL, 0);
+}
+
+static void intLock(void)
+{
+    int c = INTLOCK_FREE;
+    uint64_t start;
+    uint32_t spin;
+
+    if(__atomic_compare_exchange_n(&IntLock, &c, INTLOCK_LOCKED, 0,
+            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        ++IntStats.Entries;
+        return;
+    }
+
+    /* Contended. Spin a little, then sleep. */
+    start = Sim_clockNs();
+    for(spin = 0U; spin < INTLOCK_SPIN; ++spin)
+    {
+        c = INTLOCK_FREE;
+        if(__atomic_compare_exchange_n(&IntLock, &c, INTLOCK_LOCKED, 0,
+                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            goto locked;
+        }
+    }
+    while(__atomic_exchange_n(&IntLock, INTLOCK_CONTENDED, __ATOMIC_ACQUIRE) != INTLOCK_FREE)
+    {
+        futexWait(&IntLock, INTLOCK_CONTENDED, 0U);
+    }
+
+locked:
+    ++IntStats.Entries;
+    ++IntStats.Contended;
+    IntStats.WaitNs += Sim_clockNs() - start;
+}
+
+/* Return 1U if there may be threads waiting for the lock, 0U otherwise. */
+static uint8_t intUnlock(void)
+{
+    if(__atomic_exchange_n(&IntLock, INTLOCK_FREE, __ATOMIC_RELEASE) == INTLOCK_CONTENDED)
+    {
+        futexWake(&IntLock, 1);
+        return 1U;
+    }
+    return 0U;
+}
+
+/** Disable interrupts of the calling thread and return the previous state
+ (1U enabled, 0U disabled). Used by CRITICAL_ENTER() and INTERRUPTS_DISABLE(). */
+uint8_t Port_interruptsDisable(void)
+{
+    if(IntDisabled != 0U)
+        return 0U;
+    intLock();
+    IntDisabled = 1U;
+    return 1U;
+}
+
+/** Restore the interrupt state returned by Port_interruptsDisable(). Used by
+ CRITICAL_EXIT() and INTERRUPTS_ENABLE(). */
+void Port_interruptsRestore(uint8_t enabled)
+{
+    if(enabled != 0U && IntDisabled != 0U)
+    {
+        IntDisabled = 0U;
+        intUnlock();
+    }
+}
+
+/** Wait for an interrupt. Used by WAIT_INT().
+
+ Note: A wakeup may be lost if the interrupt runs between the check of the
+ condition and the call, the same as the microcontroller without the sleep
+ instruction tricks. The wait is therefore limited to WAIT_INT_TIMEOUT_NS. */
+void Port_waitInterrupt(void)
+{
+    int seq = __atomic_load_n(&IntSeq, __ATOMIC_ACQUIRE);
+
+    ASSERT(IntDisabled == 0U); /* Would sleep forever. */
+
+    __atomic_add_fetch(&IntSeqWaiters, 1U, __ATOMIC_SEQ_CST);
+    futexWait(&IntSeq, seq, WAIT_INT_TIMEOUT_NS);
+    __atomic_sub_fetch(&IntSeqWaiters, 1U, __ATOMIC_SEQ_CST);
+}
+
+/* Objects are waited for in a table of futexes indexed by a hash of their
+ address. Seq changes whenever an object of the bucket is woken and Waiters
+ counts the threads sleeping in the bucket, so that waking an object nobody
+ waits for does not need a system call. Objects that share a bucket only cause
+ spurious wakeups, after which the waiter tries its operation again. */
+#define WAIT_BUCKETS 64U
+
+struct WaitBucket_t {
+    int Seq;
+    uint32_t Waiters;
+} __attribute__((aligned(64)));
+
+static struct WaitBucket_t WaitBuckets[WAIT_BUCKETS];
+
+/* Threads waiting for any object (a WaitSet_t) sleep in their own bucket,
+ woken by every object and after every interrupt run, as WAIT_INT() on the
+ microcontroller. */
+static struct WaitBucket_t WaitAnyBucket;
+
+static void waitAnyWake(void)
+{
+    if(__atomic_load_n(&WaitAnyBucket.Waiters, __ATOMIC_SEQ_CST) != 0U)
+    {
+        __atomic_add_fetch(&WaitAnyBucket.Seq, 1, __ATOMIC_SEQ_CST);
+        futexWake(&WaitAnyBucket.Seq, 0x7FFFFFFF);
+    }
+}
+
+static struct WaitBucket_t *waitBucket(const volatile void *obj)
+{
+    uintptr_t addr = (uintptr_t)obj;
+    return &WaitBuckets[((addr >> 4U) ^ (addr >> 12U)) % WAIT_BUCKETS];
+}
+
+/** Register a thread that waits for obj and return the first token. Used by
+ WAIT_BEGIN(). */
+uint32_t Port_waitBegin(const volatile void *obj)
+{
+    struct WaitBucket_t *b = waitBucket(obj);
+    __atomic_add_fetch(&b->Waiters, 1U, __ATOMIC_SEQ_CST);
+    return (uint32_t)__atomic_load_n(&b->Seq, __ATOMIC_SEQ_CST);
+}
+
+/** Return a token to wait for obj again. Used by WAIT_TOKEN(). */
+uint32_t Port_waitToken(const volatile void *obj)
+{
+    return (uint32_t)__atomic_load_n(&waitBucket(obj)->Seq, __ATOMIC_SEQ_CST);
+}
+
+/** Sleep until obj is woken, unless it was woken since the token was taken,
+ or until timeout_ms milliseconds pass. Used by WAIT_OBJECT(). */
+void Port_waitObject(const volatile void *obj, uint32_t token, uint32_t timeout_ms)
+{
+    struct WaitBucket_t *b = waitBucket(obj);
+
+    ASSERT(IntDisabled == 0U); /* Would sleep forever. */
+
+    if(timeout_ms == 0U)
+        return;
+    futexWait(&b->Seq, (int)token,
+            (timeout_ms == WAIT_FOREVER) ? 0U : timeout_ms * 1000000ULL);
+}
+
+/** Unregister a thread that waited for obj. Used by WAIT_END(). */
+void Port_waitEnd(const volatile void *obj)
+{
+    __atomic_sub_fetch(&waitBucket(obj)->Waiters, 1U, __ATOMIC_SEQ_CST);
+}
+
+/** Wake the threads waiting for obj. Used by WAKE_OBJECT(). */
+void Port_wakeObject(const volatile void *obj)
+{
+    struct WaitBucket_t *b = waitBucket(obj);
+
+    __atomic_add_fetch(&b->Seq, 1, __ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&b->Waiters, __ATOMIC_SEQ_CST) != 0U)
+        futexWake(&b->Seq, 0x7FFFFFFF);
+    waitAnyWake();
+}
+
+/** Return the Linux thread ID of the calling thread. Used by THREAD_ID(). */
+uintptr_t Port_threadId(void)
+{
+    static __thread uintptr_t id = 0U;
+    if(id == 0U)
+        id = (uintptr_t)syscall(SYS_gettid);
+    return id;
+}
+
+/** Register a thread that waits for any object and return the first token.
+ Used by WAIT_ANY_BEGIN(). */
+uint32_t Port_waitAnyBegin(void)
+{
+    __atomic_add_fetch(&WaitAnyBucket.Waiters, 1U, __ATOMIC_SEQ_CST);
+    return (uint32_t)__atomic_load_n(&WaitAnyBucket.Seq, __ATOMIC_SEQ_CST);
+}
+
+/** Return a token to wait for any object again. Used by WAIT_ANY_TOKEN(). */
+uint32_t Port_waitAnyToken(void)
+{
+    return (uint32_t)__atomic_load_n(&WaitAnyBucket.Seq, __ATOMIC_SEQ_CST);
+}
+
+/** Sleep until any object is woken or an interrupt runs, unless that happened
+ since the token was taken, or until timeout_ms milliseconds pass. Used by
+ WAIT_ANY(). */
+void Port_waitAny(uint32_t token, uint32_t timeout_ms)
+{
+    ASSERT(IntDisabled == 0U); /* Would sleep forever. */
+
+    if(timeout_ms == 0U)
+        return;
+    futexWait(&WaitAnyBucket.Seq, (int)token,
+            (timeout_ms == WAIT_FOREVER) ? 0U : timeout_ms * 1000000ULL);
+}
+
+/** Unregister a thread that waited for any object. Used by WAIT_ANY_END(). */
+void Port_waitAnyEnd(void)
+{
+    __atomic_sub_fetch(&WaitAnyBucket.Waiters, 1U, __ATOMIC_SEQ_CST);
+}
+
+/* Run the handlers of the pending interrupts. */
+static void dispatch(void)
+{
+    uint32_t pending;
+    uint64_t entries;
+    uint8_t vector;
+    uint8_t contended;
+    uint32_t i;
+
+    (void)Port_interruptsDisable();
+
+    pending = __atomic_exchange_n(&IntPending, 0U, __ATOMIC_ACQUIRE);
+    for(vector = 0U; vector < SIM_NUM_VECT; ++vector)
+    {
+        if((pending & (1UL << vector)) != 0U && IsrTable[vector] != NULL)
+        {
+            ++IntStats.Interrupts;
+            IsrTable[vector]();
+        }
+    }
+
+    entries = IntStats.Entries;
+    IntDisabled = 0U;
+    contended = intUnlock();
+
+    __atomic_add_fetch(&IntSeq, 1, __ATOMIC_RELEASE);
+    if(__atomic_load_n(&IntSeqWaiters, __ATOMIC_SEQ_CST) != 0U)
+        futexWake(&IntSeq, 0x7FFFFFFF);
+    waitAnyWake();
+
+    /* Let a thread that waited for the handlers run before the next ones, like
+     the microcontroller runs at least one instruction of the main program after
+     returning from an interrupt. Otherwise an interrupt that is always pending
+     would starve the other threads. */
+    if(contended != 0U)
+    {
+        for(i = 0U; i < HANDOFF_YIELDS; ++i)
+        {
+            if(__atomic_load_n(&IntStats.Entries, __ATOMIC_RELAXED) != entries)
+                break;
+            sched_yield();
+        }
+    }
+}
+
+/* Move the scheduled interrupts that are due to IntPending and return the time
+ until the next one (0 means none is scheduled). */
+static uint64_t schedule(void)
+{
+    uint64_t now = Sim_clockNs();
+    uint64_t next = 0U;
+    uint8_t vector;
+
+    pthread_mutex_lock(&IntScheduleLock);
+    for(vector = 0U; vector < SIM_NUM_VECT; ++vector)
+    {
+        uint64_t deadline = IsrDeadline[vector];
+        if(deadline == 0U)
+            continue;
+        if(deadline <= now)
+        {
+            IsrDeadline[vector] = 0U;
+            __atomic_or_fetch(&IntPending, 1UL << vector, __ATOMIC_RELEASE);
+        }
+        else if(next == 0U || deadline - now < next)
+        {
+            next = deadline - now;
+        }
+    }
+    pthread_mutex_unlock(&IntScheduleLock);
+
+    return next;
+}
+
+static void *dispatcher(void *arg)
+{
+    (void)arg;
+
+    for(;;)
+    {
+        int wake = __atomic_load_n(&IntWake, __ATOMIC_ACQUIRE);
+        uint64_t next = schedule();
+
+        if(__atomic_load_n(&IntPending, __ATOMIC_ACQUIRE) != 0U)
+            dispatch();
+        else
+            futexWait(&IntWake, wake, next);
+    }
+
+    return NULL;
+}
+
+static void startDispatcher(void)
+{
+    pthread_t thread;
+    int err = pthread_create(&thread, NULL, &dispatcher, NULL);
+    ASSERT(err == 0);
+    (void)err;
+    pthread_detach(thread);
+}
+
+static void wakeDispatcher(void)
+{
+    __atomic_add_fetch(&IntWake, 1, __ATOMIC_RELEASE);
+    futexWake(&IntWake, 1);
+}
+
+/** Simulation: set the handler of an interrupt vector. The handler runs in the
+ dispatcher thread, with interrupts disabled. NULL disables the vector. */
+void Sim_interruptAttach(uint8_t vector, void (*isr)(void))
+{
+    ASSERT(vector < SIM_NUM_VECT);
+
+    pthread_once(&IntDispatcherOnce, &startDispatcher);
+    __atomic_store_n(&IsrTable[vector], isr, __ATOMIC_RELEASE);
+}
+
+/** Simulation: make an interrupt pending. It runs as soon as no thread has
+ interrupts disabled. */
+void Sim_interruptRaise(uint8_t vector)
+{
+    ASSERT(vector < SIM_NUM_VECT);
+
+    __atomic_or_fetch(&IntPending, 1UL << vector, __ATOMIC_RELEASE);
+    wakeDispatcher();
+}
+
+/** Simulation: make an interrupt pending at the time time_ns of Sim_clockNs().
+ A vector has only one scheduled time, the last call wins. Zero cancels it. */
+void Sim_interruptSchedule(uint8_t vector, uint64_t time_ns)
+{
+    ASSERT(vector < SIM_NUM_VECT);
+
+    pthread_mutex_lock(&IntScheduleLock);
+    IsrDeadline[vector] = time_ns;
+    pthread_mutex_unlock(&IntScheduleLock);
+    wakeDispatcher();
+}
+
+/** Simulation: return 1U if the calling thread has interrupts disabled (inside
+ a critical section or an interrupt handler), 0U otherwise. */
+uint8_t Sim_interruptsDisabled(void)
+{
+    return IntDisabled;
+}
+
+/** Simulation: copy the critical section statistics. */
+void Sim_criticalGetStats(struct SimCriticalStats_t *stats)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        *stats = IntStats;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Simulation: clear the critical section statistics. */
+void Sim_criticalResetStats(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        IntStats.Entries = 0U;
+        IntStats.Contended = 0U;
+        IntStats.WaitNs = 0U;
+        IntStats.Interrupts = 0U;
+    }
+    CRITICAL_EXIT();
+}
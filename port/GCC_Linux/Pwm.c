@@ -0,0 +1,135 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+
+#if (PWM_ENABLE != 0)
+
+/* Simulated timers 1 and 2. Like the timer of Timer.c they count at
+ F_CPU/TIMERx_PRESCALER using the host monotonic clock. */
+static uint64_t Timer1StartNs = 0U;
+static uint64_t Timer2StartNs = 0U;
+static uint8_t Timer1Running = 0U;
+static uint8_t Timer2Running = 0U;
+
+/* Output compare configuration of the PWM pins (3, 5, 6, 9, 10 and 11). */
+static uint8_t PwmModeList[MAXIO];
+static uint8_t PwmDutyList[MAXIO];
+
+void timer1Begin(void)
+{
+    Timer1StartNs = Sim_clockNs();
+    Timer1Running = 1U;
+}
+
+void timer1End(void)
+{
+    Timer1Running = 0U;
+}
+
+#if (TIMER1_OVERFLOW_INTERRUPT != 0)
+
+uint32_t timer1Counts(void)
+{
+    if(Timer1Running == 0U)
+        return 0U;
+    return (uint32_t)Sim_nsToCounts(Sim_clockNs() - Timer1StartNs,
+            F_CPU / TIMER1_PRESCALER);
+}
+
+#endif /* TIMER1_OVERFLOW_INTERRUPT */
+
+void timer2Begin(void)
+{
+    Timer2StartNs = Sim_clockNs();
+    Timer2Running = 1U;
+}
+
+void timer2End(void)
+{
+    Timer2Running = 0U;
+}
+
+#if (TIMER2_OVERFLOW_INTERRUPT != 0)
+
+uint32_t timer2Counts(void)
+{
+    if(Timer2Running == 0U)
+        return 0U;
+    return (uint32_t)Sim_nsToCounts(Sim_clockNs() - Timer2StartNs,
+            F_CPU / TIMER2_PRESCALER);
+}
+
+#endif /* TIMER2_OVERFLOW_INTERRUPT */
+
+static uint8_t isPwmPin(uint8_t pin)
+{
+    switch(pin) {
+    case 3U:
+    case 5U:
+    case 6U:
+    case 9U:
+    case 10U:
+    case 11U:
+        return 1U;
+    default:
+        return 0U;
+    }
+}
+
+void pwmMode(uint8_t pin, enum PwmModes mode)
+{
+    CRITICAL_VAL();
+
+    ASSERT(isPwmPin(pin)); /* Invalid PWM pin. */
+
+    CRITICAL_ENTER();
+    {
+        PwmModeList[pin] = mode;
+    }
+    CRITICAL_EXIT();
+}
+
+void analogWrite(uint8_t pin, uint8_t value)
+{
+    ASSERT(isPwmPin(pin)); /* Invalid PWM pin. */
+
+    PwmDutyList[pin] = value;
+}
+
+/** Simulation: return the PWM mode of the pin. See enum PwmModes. */
+uint8_t Sim_pwmGetMode(uint8_t pin)
+{
+    ASSERT(pin < MAXIO);
+    return PwmModeList[pin];
+}
+
+/** Simulation: return the duty cycle (0-255) written to the pin. */
+uint8_t Sim_pwmGetDuty(uint8_t pin)
+{
+    ASSERT(pin < MAXIO);
+    return PwmDutyList[pin];
+}
+
+#endif /* PWM_ENABLE */
@@ -0,0 +1,350 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+#include "Arduinutil_Serial.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#if (SERIAL_ENABLE != 0)
+
+SERIAL_QUEUE_DECLARE(RxQueue, SERIAL_RBUFSZ)
+SERIAL_QUEUE_DECLARE(TxQueue, SERIAL_TBUFSZ)
+
+static struct RxQueue_t RxBuff;
+static struct TxQueue_t TxBuff;
+
+/* Simulated UART. Each frame takes 10 bit times at the configured speed.
+
+ The transmitter shifts out one byte at a time through the Transmit function,
+ which by default writes to the standard output. The data register is empty
+ again at TxEmptyNs, when the data register empty interrupt is raised if it is
+ enabled.
+
+ The receiver takes the bytes of the RX line (given by Sim_serialReceive()) one
+ frame time apart and delivers each one to the receive interrupt. */
+static void defaultTransmit(uint8_t data);
+
+static void (*Transmit)(uint8_t data) = &defaultTransmit;
+static uint8_t SerialEnabled = 0U;
+static uint8_t TxIntEnabled = 0U;
+static uint64_t FrameNs = 0U;
+static uint64_t TxEmptyNs = 0U;
+
+#define SERIAL_LINE_SZ 256U
+static uint8_t RxLine[SERIAL_LINE_SZ];
+static uint16_t RxLineHead = 0U;
+static uint16_t RxLineUsed = 0U;
+
+static void usartRxIsr(void);
+static void usartUdreIsr(void);
+
+void Serial_begin(uint32_t speed, uint32_t config)
+{
+    CRITICAL_VAL();
+
+    ASSERT(speed != 0U);
+    (void)config;
+
+    CRITICAL_ENTER();
+    {
+        SerialEnabled = 0U; /* Disable TX and RX. */
+        TxIntEnabled = 0U;
+
+        RxQueue_init(&RxBuff);
+        TxQueue_init(&TxBuff);
+
+        FrameNs = 10000000000ULL / speed;
+        TxEmptyNs = 0U;
+        RxLineHead = 0U;
+        RxLineUsed = 0U;
+
+        Sim_interruptAttach(SIM_USART_RX_VECT, &usartRxIsr);
+        Sim_interruptAttach(SIM_USART_UDRE_VECT, &usartUdreIsr);
+
+        SerialEnabled = 1U;
+    }
+    CRITICAL_EXIT();
+}
+
+void Serial_end(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        SerialEnabled = 0U; /* Disable TX and RX. */
+        TxIntEnabled = 0U;
+        Sim_interruptSchedule(SIM_USART_RX_VECT, 0U);
+        Sim_interruptSchedule(SIM_USART_UDRE_VECT, 0U);
+    }
+    CRITICAL_EXIT();
+}
+
+Size_t Serial_available(void)
+{
+    return RxQueue_used(&RxBuff);
+}
+
+void Serial_flush(void)
+{
+    while(TxQueue_used(&TxBuff) != 0U)
+    {
+        WAIT_INT();
+    }
+    fflush(stdout);
+}
+
+/* Put data in the transmitter. Must be called with interrupts disabled. */
+static void usartTransmit(uint8_t data)
+{
+    uint64_t now = Sim_clockNs();
+    Transmit(data);
+    TxEmptyNs = ((TxEmptyNs > now) ? TxEmptyNs : now) + FrameNs;
+}
+
+void Serial_writeByte(uint8_t data)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+
+    if(     Sim_clockNs() >= TxEmptyNs &&
+            TxQueue_empty(&TxBuff))
+    {
+        usartTransmit(data);
+    }
+    else
+    {
+        if(TxIntEnabled == 0U)
+        {
+            TxIntEnabled = 1U;
+            Sim_interruptSchedule(SIM_USART_UDRE_VECT, TxEmptyNs);
+        }
+        while(!TxQueue_write(&TxBuff, &data))
+        {
+            CRITICAL_EXIT();
+
+            WAIT_INT();
+
+            CRITICAL_ENTER();
+        }
+    }
+
+    CRITICAL_EXIT();
+}
+
+/* Enable the transmit interrupt, which sends the data in TxBuff. */
+static void usartTxStart(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    if(TxIntEnabled == 0U)
+    {
+        TxIntEnabled = 1U;
+        if(Sim_clockNs() >= TxEmptyNs)
+            Sim_interruptRaise(SIM_USART_UDRE_VECT);
+        else
+            Sim_interruptSchedule(SIM_USART_UDRE_VECT, TxEmptyNs);
+    }
+    CRITICAL_EXIT();
+}
+
+void Serial_write(const void *str)
+{
+    Serial_writeBuff(str, strlen((const char *)str));
+}
+
+void Serial_writeBuff(const void *buff, uint16_t length)
+{
+    const uint8_t *b = (const uint8_t *)buff;
+
+    while(length != 0U)
+    {
+        Size_t num = TxQueue_write_n(&TxBuff, b,
+                (length < SERIAL_TBUFSZ) ? length : SERIAL_TBUFSZ);
+        if(num != 0U)
+        {
+            b += num;
+            length -= num;
+            usartTxStart();
+        }
+        else
+        {
+            WAIT_INT();
+        }
+    }
+}
+
+int Serial_print(const char *format, ...)
+{
+    int used_length;
+    uint8_t *ptr;
+    Size_t contig;
+    va_list vl;
+
+    va_start(vl, format);
+    if(     TxQueue_reserve(&TxBuff, SERIAL_PRINT_BUFSZ, &ptr, &contig) &&
+            contig == SERIAL_PRINT_BUFSZ)
+    {
+        /* Format directly in the transmit buffer. */
+        used_length = vsnprintf((char *)ptr, SERIAL_PRINT_BUFSZ, format, vl);
+        if(used_length > 0)
+        {
+            TxQueue_commit(&TxBuff, (used_length < (int)SERIAL_PRINT_BUFSZ) ?
+                    (Size_t)used_length : SERIAL_PRINT_BUFSZ - 1U);
+            usartTxStart();
+        }
+    }
+    else
+    {
+        char buf[SERIAL_PRINT_BUFSZ];
+        used_length = vsnprintf(buf, SERIAL_PRINT_BUFSZ, format, vl);
+        Serial_write(buf);
+    }
+    va_end(vl);
+    return used_length;
+}
+
+int16_t Serial_read(void)
+{
+    uint8_t data;
+    if(RxQueue_read(&RxBuff, &data))
+        return data;
+    else
+        return -1;
+}
+
+uint16_t Serial_readBuff(void *buff, uint16_t length)
+{
+    return RxQueue_read_n(&RxBuff, buff,
+            (length < SERIAL_RBUFSZ) ? length : SERIAL_RBUFSZ);
+}
+
+#if (QUEUE_STATS_ENABLE != 0)
+
+void Serial_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_getstats(&RxBuff, rx);
+        TxQueue_getstats(&TxBuff, tx);
+    }
+    CRITICAL_EXIT();
+}
+
+void Serial_resetStats(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_resetstats(&RxBuff);
+        TxQueue_resetstats(&TxBuff);
+    }
+    CRITICAL_EXIT();
+}
+
+#endif /* QUEUE_STATS_ENABLE */
+
+/** Simulation: send bytes to the RX line. The bytes reach the receive
+ interrupt one frame time apart. Bytes that do not fit in the receive buffer
+ when they arrive are lost, the same as an overrun in the hardware.
+
+ @return Number of bytes put in the line (up to SERIAL_LINE_SZ are kept). */
+uint16_t Sim_serialReceive(const void *buff, uint16_t length)
+{
+    const uint8_t *b = (const uint8_t *)buff;
+    uint16_t num = 0U;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        if(SerialEnabled != 0U)
+        {
+            if(RxLineUsed == 0U)
+                Sim_interruptSchedule(SIM_USART_RX_VECT, Sim_clockNs() + FrameNs);
+
+            while(num < length && RxLineUsed < SERIAL_LINE_SZ)
+            {
+                RxLine[(RxLineHead + RxLineUsed) % SERIAL_LINE_SZ] = b[num++];
+                ++RxLineUsed;
+            }
+        }
+    }
+    CRITICAL_EXIT();
+    return num;
+}
+
+/** Simulation: set the function that receives the bytes the UART transmits.
+ NULL restores the default, which writes them to the standard output. */
+void Sim_serialSetTransmitter(void (*transmit)(uint8_t data))
+{
+    Transmit = (transmit != NULL) ? transmit : &defaultTransmit;
+}
+
+static void defaultTransmit(uint8_t data)
+{
+    fputc(data, stdout);
+}
+
+static void usartRxIsr(void)
+{
+    uint8_t data;
+
+    if(SerialEnabled == 0U || RxLineUsed == 0U)
+        return;
+
+    data = RxLine[RxLineHead];
+    RxLineHead = (RxLineHead + 1U) % SERIAL_LINE_SZ;
+    --RxLineUsed;
+    if(RxLineUsed != 0U)
+        Sim_interruptSchedule(SIM_USART_RX_VECT, Sim_clockNs() + FrameNs);
+
+    RxQueue_write(&RxBuff, &data);
+}
+
+static void usartUdreIsr(void)
+{
+    uint8_t data;
+
+    if(TxIntEnabled == 0U)
+        return;
+
+    if(TxQueue_read(&TxBuff, &data))
+    {
+        usartTransmit(data);
+        Sim_interruptSchedule(SIM_USART_UDRE_VECT, TxEmptyNs);
+    }
+    else
+    {
+        TxIntEnabled = 0U;
+    }
+}
+
+#endif /* SERIAL_ENABLE */
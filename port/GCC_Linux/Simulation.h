@@ -0,0 +1,125 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef __ARDUINUTIL_SIMULATION_H__
+#define __ARDUINUTIL_SIMULATION_H__
+
+#include "Config.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The host port replaces the microcontroller peripherals with in-process
+ models. The application uses the normal Arduinutil API and the test or
+ simulation code uses the functions below to play the role of the outside
+ world: drive input pins, set analog values, feed serial data, attach I2C
+ devices and watch what the firmware did. */
+
+/* Arduinutil.c */
+uint64_t Sim_clockNs(void);
+uint64_t Sim_nsToCounts(uint64_t ns, uint32_t rate);
+
+/* Interrupt.c */
+enum SimInterruptVectors {
+    SIM_INT0_VECT = 0U,
+    SIM_INT1_VECT,
+    SIM_PCINT_VECT,
+    SIM_USART_RX_VECT,
+    SIM_USART_UDRE_VECT,
+    SIM_WDT_VECT,
+    /* Free for simulated devices of the application. */
+    SIM_USER0_VECT,
+    SIM_USER1_VECT,
+    SIM_USER2_VECT,
+    SIM_USER3_VECT,
+    SIM_NUM_VECT
+};
+
+struct SimCriticalStats_t {
+    uint64_t Entries;   /* Critical sections entered (outermost level). */
+    uint64_t Contended; /* Entries that had to wait for another thread. */
+    uint64_t WaitNs;    /* Total time waited by the contended entries. */
+    uint64_t Interrupts; /* Interrupt handlers run. */
+};
+
+void Sim_interruptAttach(uint8_t vector, void (*isr)(void));
+void Sim_interruptRaise(uint8_t vector);
+void Sim_interruptSchedule(uint8_t vector, uint64_t time_ns);
+uint8_t Sim_interruptsDisabled(void);
+void Sim_criticalGetStats(struct SimCriticalStats_t *stats);
+void Sim_criticalResetStats(void);
+
+/* Digital.c */
+void Sim_digitalDrive(uint8_t io, uint8_t value);
+void Sim_digitalRelease(uint8_t io);
+uint8_t Sim_digitalGetOutput(uint8_t io);
+uint8_t Sim_digitalGetMode(uint8_t io);
+#if (DIGITAL_EXTERNAL_INT_ENABLE != 0)
+    void Sim_digitalSetPinChangeIsr(void (*isr)(void));
+#endif
+
+/* Analog.c */
+#if (ANALOG_ENABLE != 0)
+    void Sim_analogSetInput(uint8_t analog, uint16_t value);
+    uint8_t Sim_analogGetReference(void);
+#endif
+
+/* Pwm.c */
+#if (PWM_ENABLE != 0)
+    uint8_t Sim_pwmGetMode(uint8_t pin);
+    uint8_t Sim_pwmGetDuty(uint8_t pin);
+#endif
+
+/* Serial.c */
+#if (SERIAL_ENABLE != 0)
+    uint16_t Sim_serialReceive(const void *buff, uint16_t length);
+    void Sim_serialSetTransmitter(void (*transmit)(uint8_t data));
+#endif
+
+/* I2c.c */
+#if (I2C_ENABLE != 0)
+    /* Simulated I2C slave. write() returns 1U to ACK the byte and 0U to NACK
+     it. read() returns the next byte the slave sends. stop() is called when the
+     master sends a stop condition and may be NULL. */
+    struct SimI2cDevice_t {
+        uint8_t (*write)(uint8_t data);
+        uint8_t (*read)(void);
+        void (*stop)(void);
+    };
+
+    void Sim_i2cAttach(uint8_t addr, const struct SimI2cDevice_t *dev);
+    void Sim_i2cDetach(uint8_t addr);
+#endif
+
+/* Watchdog.c */
+#if (WATCHDOG_ENABLE != 0)
+    void Sim_wdtSetResetHandler(void (*handler)(void));
+    uint8_t Sim_wdtCheck(void);
+#endif
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __ARDUINUTIL_SIMULATION_H__ */
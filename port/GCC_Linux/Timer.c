@@ -0,0 +1,172 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Arduinutil_Timer.h"
+#include "Simulation.h"
+#include "Data/seqlock.h"
+#include <time.h>
+
+#if (TIMER_ENABLE != 0)
+
+/* The simulated timer counts at F_CPU/TIMER_PRESCALER, the same rate of the
+ hardware timer, using the host monotonic clock. */
+static uint64_t TimerStartNs = 0U;
+static uint32_t TimerSleepedCounts = 0U;
+static uint8_t TimerRunning = 0U;
+#if (SEQLOCK_ENABLE != 0)
+/* Readers (timerCounts()) take TimerStartNs and TimerSleepedCounts with the
+ seqlock. The writers still take a critical section to be serialized. The
+ fields are accessed with relaxed atomics, which cost nothing on the host, so
+ that the race the seqlock allows is a defined one. */
+static struct SeqLock_t TimerLock = SEQLOCK_INIT;
+#define LOAD_RELAXED(ptr)       __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define STORE_RELAXED(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+#endif
+
+/** Enable Timer. */
+void timerBegin(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+#if (SEQLOCK_ENABLE != 0)
+        SeqLock_writebegin(&TimerLock);
+        STORE_RELAXED(&TimerStartNs, Sim_clockNs());
+        STORE_RELAXED(&TimerSleepedCounts, 0U);
+        SeqLock_writeend(&TimerLock);
+#else
+        TimerStartNs = Sim_clockNs();
+        TimerSleepedCounts = 0U;
+#endif
+        TimerRunning = 1U;
+    }
+    CRITICAL_EXIT();
+}
+
+/** Disable Timer. */
+void timerEnd(void)
+{
+    TimerRunning = 0U;
+}
+
+/** Return the number of milliseconds the timer is running. */
+uint32_t millis(void)
+{
+    return TIMER_COUNT_TO_MS(timerCounts());
+}
+
+/** Return the number of microseconds the timer is running. */
+uint32_t micros(void)
+{
+    return TIMER_COUNT_TO_US(timerCounts());
+}
+
+/** Return the number of counts the timer had. */
+uint32_t timerCounts(void)
+{
+    uint64_t elapsed;
+    uint32_t sleeped;
+#if (SEQLOCK_ENABLE != 0)
+    Size_t seq;
+
+    if(TimerRunning == 0U)
+        return 0U;
+
+    do {
+        seq = SeqLock_readbegin(&TimerLock);
+        elapsed = LOAD_RELAXED(&TimerStartNs);
+        sleeped = LOAD_RELAXED(&TimerSleepedCounts);
+    } while(SeqLock_readretry(&TimerLock, seq) != 0U);
+    elapsed = Sim_clockNs() - elapsed;
+#else
+    CRITICAL_VAL();
+
+    if(TimerRunning == 0U)
+        return 0U;
+
+    CRITICAL_ENTER();
+    {
+        elapsed = Sim_clockNs() - TimerStartNs;
+        sleeped = TimerSleepedCounts;
+    }
+    CRITICAL_EXIT();
+#endif
+    return (uint32_t)Sim_nsToCounts(elapsed, F_CPU / TIMER_PRESCALER) + sleeped;
+}
+
+/** Add counts to timer counter variable.
+
+ The host does not sleep with the timer stopped, but the function is kept so
+ the application code that calls it runs unchanged. */
+void timerAddSleepedCounts(uint32_t counts)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+#if (SEQLOCK_ENABLE != 0)
+        SeqLock_writebegin(&TimerLock);
+        STORE_RELAXED(&TimerSleepedCounts, TimerSleepedCounts + counts);
+        SeqLock_writeend(&TimerLock);
+#else
+        TimerSleepedCounts += counts;
+#endif
+    }
+    CRITICAL_EXIT();
+}
+
+/** Stop execution for a given time in milliseconds. */
+void delay(uint32_t ms)
+{
+    delayCounts(TIMER_MS_TO_COUNT(ms));
+}
+
+/** Stop execution for a given time in microseconds. */
+void delayMicroseconds(uint32_t us)
+{
+    delayCounts(TIMER_US_TO_COUNT(us));
+}
+
+/** Stop execution for a given number of timer counts.
+
+ Note: The thread sleeps instead of busy waiting. */
+void delayCounts(uint32_t counts)
+{
+    uint32_t call_time = timerCounts();
+    uint32_t elapsed;
+    while((elapsed = timerCounts() - call_time) < counts)
+    {
+        uint64_t ns = (uint64_t)(counts - elapsed) * 1000000000ULL /
+                (F_CPU / TIMER_PRESCALER);
+        struct timespec ts;
+        ts.tv_sec = (time_t)(ns / 1000000000ULL);
+        ts.tv_nsec = (long)(ns % 1000000000ULL);
+        nanosleep(&ts, NULL);
+    }
+}
+
+#endif /* TIMER_ENABLE */
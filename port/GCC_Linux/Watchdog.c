@@ -0,0 +1,144 @@
+/*
+ Arduinutil - Arduino-like library written in C
+
+ Supported microcontrollers:
+ See Arduinutil.h
+
+
+ Copyright 2016 Djones A. Boni
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "Arduinutil.h"
+#include "Config.h"
+#include "Simulation.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if (WATCHDOG_ENABLE != 0)
+
+/* Simulated watchdog. It expires when more than WdtTimeoutNs pass between two
+ resets. The watchdog interrupt is scheduled to the deadline and calls the
+ reset handler if the watchdog has not been reset in the meantime. */
+static void defaultResetHandler(void);
+static void wdtIsr(void);
+
+static void (*ResetHandler)(void) = &defaultResetHandler;
+static uint64_t WdtTimeoutNs = 0U;
+static uint64_t WdtDeadlineNs = 0U;
+static uint8_t WdtEnabled = 0U;
+
+void Wdt_enable(uint16_t timeout_ms)
+{
+    CRITICAL_VAL();
+
+    ASSERT(timeout_ms != 0U); /* Invalid watchdog timeout. */
+
+    Sim_interruptAttach(SIM_WDT_VECT, &wdtIsr);
+
+    CRITICAL_ENTER();
+    {
+        WdtTimeoutNs = timeout_ms * 1000000ULL;
+        WdtDeadlineNs = Sim_clockNs() + WdtTimeoutNs;
+        WdtEnabled = 1U;
+        Sim_interruptSchedule(SIM_WDT_VECT, WdtDeadlineNs);
+    }
+    CRITICAL_EXIT();
+}
+
+void Wdt_disable(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        WdtEnabled = 0U;
+        Sim_interruptSchedule(SIM_WDT_VECT, 0U);
+    }
+    CRITICAL_EXIT();
+}
+
+void Wdt_reset(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        if(Sim_wdtCheck() == 0U && WdtEnabled != 0U)
+        {
+            WdtDeadlineNs = Sim_clockNs() + WdtTimeoutNs;
+            Sim_interruptSchedule(SIM_WDT_VECT, WdtDeadlineNs);
+        }
+    }
+    CRITICAL_EXIT();
+}
+
+/** Simulation: set the function called when the watchdog expires. NULL
+ restores the default, which aborts the program. */
+void Sim_wdtSetResetHandler(void (*handler)(void))
+{
+    ResetHandler = (handler != NULL) ? handler : &defaultResetHandler;
+}
+
+/** Simulation: check the watchdog and call the reset handler if it has
+ expired. Return 1U if it has expired, 0U otherwise. */
+uint8_t Sim_wdtCheck(void)
+{
+    uint8_t expired;
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        expired = (WdtEnabled != 0U && Sim_clockNs() >= WdtDeadlineNs);
+        if(expired)
+            WdtEnabled = 0U; /* The watchdog is disabled after a reset. */
+    }
+    CRITICAL_EXIT();
+
+    if(expired)
+        ResetHandler();
+    return expired;
+}
+
+static void wdtIsr(void)
+{
+    (void)Sim_wdtCheck();
+}
+
+static void defaultResetHandler(void)
+{
+    fprintf(stderr, "Watchdog reset\n");
+    abort();
+}
+
+#if (WATCHDOG_AUTOINIT != 0)
+
+/* Run before main(), like the .init3 section of the AVR ports. */
+__attribute__((constructor))
+static void wdt_init(void)
+{
+    #if (WATCHDOG_AUTOINIT_TIMEOUT != 0U)
+    {
+        Wdt_enable(WATCHDOG_AUTOINIT_TIMEOUT);
+    }
+    #else
+    {
+        Wdt_disable();
+    }
+    #endif
+}
+
+#endif /* WATCHDOG_AUTOINIT */
+
+#endif /* WATCHDOG_ENABLE */
@@ -23,26 +23,169 @@
 #ifndef __ARDUINUTIL_PORT_H__
 #define __ARDUINUTIL_PORT_H__
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
-#else
-/* Avoid C90 complaining about inline in some AVR headers. */
-#define inline __inline
 #endif
 
-#define INTERRUPTS_DISABLE() do{}while(0U)
-#define INTERRUPTS_ENABLE()  do{}while(0U)
+/*******************************************************************************
+ Timer.c
+ ******************************************************************************/
+
+#define TIMER_COUNT_TO_MS(x) ((uint32_t)((uint64_t)(x) * TIMER_PRESCALER / (F_CPU / 1000UL)))
+#define TIMER_MS_TO_COUNT(x) ((uint32_t)((uint64_t)(x) * (F_CPU / 1000UL) / TIMER_PRESCALER))
+
+#define TIMER_COUNT_TO_US(x) ((uint32_t)((uint64_t)(x) * (TIMER_PRESCALER * 125UL) / (F_CPU / 8000UL)))
+#define TIMER_US_TO_COUNT(x) ((uint32_t)((uint64_t)(x) * (F_CPU / 8000UL) / (TIMER_PRESCALER * 125UL)))
+
+/*******************************************************************************
+ Digital.c
+ ******************************************************************************/
+
+/* The host port simulates the pinout of an Arduino Uno. */
+#define ANALOGIO 14U
+#define MAXIO    (ANALOGIO + 6U)
+
+enum DigitalPinModes {
+    LOW = 0U,
+    HIGH = 1U,
+
+    INPUT = 0U,
+    OUTPUT = 1U,
+    INPUT_PULLUP = 2U
+};
+
+enum DigitalInterruptModes {
+    /* LOW = 0x00U, */
+    CHANGE = 0x01U,
+    FALLING = 0x02U,
+    RISING = 0x03U
+};
+
+/*******************************************************************************
+ Analog.c
+ ******************************************************************************/
+
+/* Analog/Digital pins */
+#define A0       (ANALOGIO + 0U)
+#define A1       (ANALOGIO + 1U)
+#define A2       (ANALOGIO + 2U)
+#define A3       (ANALOGIO + 3U)
+#define A4       (ANALOGIO + 4U)
+#define A5       (ANALOGIO + 5U)
+/* Analog only pins */
+#define A6       (ANALOGIO + 6U)
+#define A7       (ANALOGIO + 7U)
+/* Analog only internal */
+#define ATEMP    (ANALOGIO + 8U)
+#define A1V1     (ANALOGIO + 14U)
+#define MAXANALOG 16U
+
+enum AnalogReferences {
+    EXTERNAL = 0x00U, /* External voltage on AREF. */
+    INTERNALVCC = 0x01U, /* Internal voltage VCC. */
+    INTERNAL1V1 = 0x03U, /* Internal voltage reference 1.1V. */
+    /* Arduino IDE compatibility. */
+    DEFAULT = INTERNALVCC,
+    INTERNAL = INTERNAL1V1
+};
 
-#define CRITICAL_VAL()
-#define CRITICAL_ENTER() do{}while(0U)
-#define CRITICAL_EXIT()  do{}while(0U)
+/*******************************************************************************
+ Pwm.c
+ ******************************************************************************/
+
+enum PwmModes {
+    PWM_DISABLE  = 0U,
+    PWM_NOINVERT = 2U,
+    PWM_INVERT   = 3U
+};
+
+/*******************************************************************************
+ Others
+ ******************************************************************************/
+
+/* Interrupt.c - Interrupts are simulated by a dispatcher thread and masked by
+ a lock. See Interrupt.c for details. */
+uint8_t Port_interruptsDisable(void);
+void Port_interruptsRestore(uint8_t enabled);
+void Port_waitInterrupt(void);
+
+#define INTERRUPTS_DISABLE() ((void)Port_interruptsDisable())
+#define INTERRUPTS_ENABLE()  Port_interruptsRestore(1U)
+
+#define CRITICAL_VAL()   uint8_t __istate_val
+#define CRITICAL_ENTER() do{ __istate_val = Port_interruptsDisable(); }while(0U)
+#define CRITICAL_EXIT()  Port_interruptsRestore(__istate_val)
 
 #define CRITICAL_ENTER_IF_CONCURRENT() if(Concurrent) CRITICAL_ENTER()
 #define CRITICAL_EXIT_IF_CONCURRENT()  if(Concurrent) CRITICAL_EXIT()
 
-#define WAIT_INT() do{}while(0U)
+#define WAIT_INT() Port_waitInterrupt()
 #define WAIT_BUSY() do{}while(0U)
 
+/* Interrupt.c - Threads waiting for an object (see Data/wait.h) sleep on a
+ futex. */
+uint32_t Port_waitBegin(const volatile void *obj);
+uint32_t Port_waitToken(const volatile void *obj);
+void Port_waitObject(const volatile void *obj, uint32_t token, uint32_t timeout_ms);
+void Port_waitEnd(const volatile void *obj);
+void Port_wakeObject(const volatile void *obj);
+uint32_t Port_waitAnyBegin(void);
+uint32_t Port_waitAnyToken(void);
+void Port_waitAny(uint32_t token, uint32_t timeout_ms);
+void Port_waitAnyEnd(void);
+
+#define WAIT_BEGIN(obj)  Port_waitBegin(obj)
+#define WAIT_TOKEN(obj)  Port_waitToken(obj)
+#define WAIT_OBJECT(obj, token, timeout_ms) Port_waitObject(obj, token, timeout_ms)
+#define WAIT_END(obj)    Port_waitEnd(obj)
+#define WAKE_OBJECT(obj) Port_wakeObject(obj)
+#define WAIT_ANY_BEGIN() Port_waitAnyBegin()
+#define WAIT_ANY_TOKEN() Port_waitAnyToken()
+#define WAIT_ANY(token, timeout_ms) Port_waitAny(token, timeout_ms)
+#define WAIT_ANY_END()   Port_waitAnyEnd()
+
+/* Thread identifier of the owner of Mutex_t and clock for its profiling (see
+ MUTEX_STATS_ENABLE). */
+uint64_t Sim_clockNs(void);
+uintptr_t Port_threadId(void);
+
+#define STATS_CLOCK_NS() Sim_clockNs()
+#define THREAD_ID()      Port_threadId()
+
+/*******************************************************************************
+ Serial.c
+ ******************************************************************************/
+
+/* Data bits, parity (0=none, 1=even, 2=odd) and stop bits. The simulated UART
+ only records the configuration. */
+#define SERIAL_CONF(A,B,C) ((A)|((B)<<8UL)|((C)<<16UL))
+#define SERIAL_5N1 SERIAL_CONF(5UL, 0UL, 1UL)
+#define SERIAL_6N1 SERIAL_CONF(6UL, 0UL, 1UL)
+#define SERIAL_7N1 SERIAL_CONF(7UL, 0UL, 1UL)
+#define SERIAL_8N1 SERIAL_CONF(8UL, 0UL, 1UL)
+#define SERIAL_5N2 SERIAL_CONF(5UL, 0UL, 2UL)
+#define SERIAL_6N2 SERIAL_CONF(6UL, 0UL, 2UL)
+#define SERIAL_7N2 SERIAL_CONF(7UL, 0UL, 2UL)
+#define SERIAL_8N2 SERIAL_CONF(8UL, 0UL, 2UL)
+#define SERIAL_5E1 SERIAL_CONF(5UL, 1UL, 1UL)
+#define SERIAL_6E1 SERIAL_CONF(6UL, 1UL, 1UL)
+#define SERIAL_7E1 SERIAL_CONF(7UL, 1UL, 1UL)
+#define SERIAL_8E1 SERIAL_CONF(8UL, 1UL, 1UL)
+#define SERIAL_5E2 SERIAL_CONF(5UL, 1UL, 2UL)
+#define SERIAL_6E2 SERIAL_CONF(6UL, 1UL, 2UL)
+#define SERIAL_7E2 SERIAL_CONF(7UL, 1UL, 2UL)
+#define SERIAL_8E2 SERIAL_CONF(8UL, 1UL, 2UL)
+#define SERIAL_5O1 SERIAL_CONF(5UL, 2UL, 1UL)
+#define SERIAL_6O1 SERIAL_CONF(6UL, 2UL, 1UL)
+#define SERIAL_7O1 SERIAL_CONF(7UL, 2UL, 1UL)
+#define SERIAL_8O1 SERIAL_CONF(8UL, 2UL, 1UL)
+#define SERIAL_5O2 SERIAL_CONF(5UL, 2UL, 2UL)
+#define SERIAL_6O2 SERIAL_CONF(6UL, 2UL, 2UL)
+#define SERIAL_7O2 SERIAL_CONF(7UL, 2UL, 2UL)
+#define SERIAL_8O2 SERIAL_CONF(8UL, 2UL, 2UL)
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -21,16 +21,18 @@
  */
 
 #include "Arduinutil.h"
-#include "Data/queue.h"
+#include "Arduinutil_Serial.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 #if (SERIAL_ENABLE != 0)
 
-static uint8_t RxBuff_data[SERIAL_RBUFSZ];
-static uint8_t TxBuff_data[SERIAL_TBUFSZ];
-static struct Queue_t RxBuff;
-static struct Queue_t TxBuff;
+SERIAL_QUEUE_DECLARE(RxQueue, SERIAL_RBUFSZ)
+SERIAL_QUEUE_DECLARE(TxQueue, SERIAL_TBUFSZ)
+
+static struct RxQueue_t RxBuff;
+static struct TxQueue_t TxBuff;
 
 void Serial_begin(uint32_t speed, uint32_t config)
 {
@@ -42,8 +44,8 @@ void Serial_begin(uint32_t speed, uint32_t config)
     br = (br3 >> 3U);
     mctl = (br3 & 0x07U) << 1U;
 
-    Queue_init(&RxBuff, &RxBuff_data, sizeof(RxBuff_data), 1);
-    Queue_init(&TxBuff, &TxBuff_data, sizeof(TxBuff_data), 1);
+    RxQueue_init(&RxBuff);
+    TxQueue_init(&TxBuff);
 
     /* Configure TX and RX pins. */
     P1REN &= ~(BIT1 | BIT2);
@@ -79,12 +81,12 @@ void Serial_end(void)
 
 Size_t Serial_available(void)
 {
-    return Queue_used(&RxBuff);
+    return RxQueue_used(&RxBuff);
 }
 
 void Serial_flush(void)
 {
-    while(Queue_used(&TxBuff) != 0U)
+    while(TxQueue_used(&TxBuff) != 0U)
     {
         YIELD();
     }
@@ -97,14 +99,14 @@ void Serial_writeByte(uint8_t data)
     CRITICAL_ENTER();
 
     if(     (IFG2 & UCA0TXIFG) &&
-            Queue_empty(&TxBuff))
+            TxQueue_empty(&TxBuff))
     {
         UCA0TXBUF = data;
     }
     else
     {
         IE2 |= UCA0TXIE; /* Enable TX interrupt */
-        while(!Queue_write(&TxBuff, &data))
+        while(!TxQueue_write(&TxBuff, &data))
         {
             CRITICAL_EXIT();
 
@@ -117,41 +119,97 @@ void Serial_writeByte(uint8_t data)
     CRITICAL_EXIT();
 }
 
+/* Enable the transmit interrupt, which sends the data in TxBuff. */
+static void usartTxStart(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    IE2 |= UCA0TXIE;
+    CRITICAL_EXIT();
+}
+
 void Serial_write(const void *str)
 {
-    const uint8_t *s = (const uint8_t *)str;
-    while(*s != 0U)
-        Serial_writeByte(*s++);
+    Serial_writeBuff(str, strlen((const char *)str));
 }
 
 void Serial_writeBuff(const void *buff, uint16_t length)
 {
     const uint8_t *b = (const uint8_t *)buff;
-    while(length-- != 0)
-        Serial_writeByte(*b++);
+
+    while(length != 0U)
+    {
+        Size_t num = TxQueue_write_n(&TxBuff, b,
+                (length < SERIAL_TBUFSZ) ? length : SERIAL_TBUFSZ);
+        if(num != 0U)
+        {
+            b += num;
+            length -= num;
+            usartTxStart();
+        }
+        else
+        {
+            YIELD();
+        }
+    }
 }
 
 int16_t Serial_read(void)
 {
     uint8_t data;
-    if(Queue_read(&RxBuff, &data))
+    if(RxQueue_read(&RxBuff, &data))
         return data;
     else
         return -1;
 }
 
+uint16_t Serial_readBuff(void *buff, uint16_t length)
+{
+    return RxQueue_read_n(&RxBuff, buff,
+            (length < SERIAL_RBUFSZ) ? length : SERIAL_RBUFSZ);
+}
+
+#if (QUEUE_STATS_ENABLE != 0)
+
+void Serial_getStats(struct QueueStats_t *rx, struct QueueStats_t *tx)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_getstats(&RxBuff, rx);
+        TxQueue_getstats(&TxBuff, tx);
+    }
+    CRITICAL_EXIT();
+}
+
+void Serial_resetStats(void)
+{
+    CRITICAL_VAL();
+
+    CRITICAL_ENTER();
+    {
+        RxQueue_resetstats(&RxBuff);
+        TxQueue_resetstats(&TxBuff);
+    }
+    CRITICAL_EXIT();
+}
+
+#endif /* QUEUE_STATS_ENABLE */
+
 __attribute__((interrupt(USCIAB0RX_VECTOR)))
 void usci0rx_isr(void)
 {
     uint8_t data = UCA0RXBUF;
-    Queue_write(&RxBuff, &data);
+    RxQueue_write(&RxBuff, &data);
 }
 
 __attribute__((interrupt(USCIAB0TX_VECTOR)))
 void usci0tx_isr(void)
 {
     uint8_t data;
-    if(Queue_read(&TxBuff, &data))
+    if(TxQueue_read(&TxBuff, &data))
         UCA0TXBUF = data;
     else
         IE2 &= ~UCA0TXIE; /* Disable TX interrupt. */
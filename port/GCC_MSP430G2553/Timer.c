@@ -22,10 +22,14 @@
 
 #include "Arduinutil.h"
 #include "Arduinutil_Timer.h"
+#include "Data/seqlock.h"
 
 #if (TIMER_ENABLE != 0)
 
 static uint32_t TimerIntCount = 0U;
+#if (SEQLOCK_ENABLE != 0)
+static struct SeqLock_t TimerLock = SEQLOCK_INIT;
+#endif
 
 /** Enable Timer. */
 void timerBegin(void)
@@ -73,7 +77,13 @@ void timer0_a1_isr(void)
 {
     if(TAIV == 0x0AU /* TAIFG */)
     {
+#if (SEQLOCK_ENABLE != 0)
+        SeqLock_writebegin(&TimerLock);
         TimerIntCount += 1UL;
+        SeqLock_writeend(&TimerLock);
+#else
+        TimerIntCount += 1UL;
+#endif
     }
 }
 
@@ -93,6 +103,29 @@ uint32_t micros(void)
     return TIMER_COUNT_TO_US(timerCounts());
 }
 
+/* Read the timer register. Must be called with TimerIntCount read in the
+ same critical section (or seqlock read). */
+static uint16_t timerRegister(void)
+{
+    uint16_t timerCount;
+
+    #if 1
+    {
+        /* Capture disabled */
+        timerCount = TAR;
+        if(TACTL & TAIFG)
+            timerCount = 65535U;
+    }
+    #else
+    {
+        /* Capture enabled - lose precision for consistency */
+        timerCount = 0U;
+    }
+    #endif
+
+    return timerCount;
+}
+
 /** Return the number of counts the timer had.
 
  Note: This function may return an outdated value if interrupts are disabled. */
@@ -105,27 +138,25 @@ uint32_t timerCounts(void)
 
     uint32_t timerIntCount;
     uint16_t timerCount;
+#if (SEQLOCK_ENABLE != 0)
+    Size_t seq;
+
+    /* Read again if the overflow interrupt ran meanwhile. */
+    do {
+        seq = SeqLock_readbegin(&TimerLock);
+        timerIntCount = TimerIntCount;
+        timerCount = timerRegister();
+    } while(SeqLock_readretry(&TimerLock, seq) != 0U);
+#else
     CRITICAL_VAL();
 
     CRITICAL_ENTER();
     {
         timerIntCount = TimerIntCount;
-
-        #if 1
-        {
-            /* Capture disabled */
-            timerCount = TAR;
-            if(TACTL & TAIFG)
-                timerCount = 65535U;
-        }
-        #else
-        {
-            /* Capture enabled - lose precision for consistency */
-            timerCount = 0U;
-        }
-        #endif
+        timerCount = timerRegister();
     }
     CRITICAL_EXIT();
+#endif
 
     return (timerIntCount * 65536U + timerCount);
 }
@@ -148,7 +179,13 @@ void timerAddSleepedCounts(uint32_t counts)
 
     CRITICAL_ENTER();
     {
+#if (SEQLOCK_ENABLE != 0)
+        SeqLock_writebegin(&TimerLock);
+        TimerIntCount += counts / 65536U;
+        SeqLock_writeend(&TimerLock);
+#else
         TimerIntCount += counts / 65536U;
+#endif
     }
     CRITICAL_EXIT();
 }